@@ -0,0 +1,237 @@
+/*
+==============================================================================
+    AllocationGuard.cpp
+==============================================================================
+*/
+
+#include <juce_core/juce_core.h>
+#include "AllocationGuard.h"
+
+#include <cstdlib>
+#include <new>
+
+#if JUCE_DEBUG
+
+// malloc/calloc/realloc selbst prüfen: Linux per Interposer (nur in diesem Binary),
+// macOS über die Default-Zone, MSVC über den Alloc-Hook der Debug-CRT. Unter ASan
+// nicht - der Sanitizer ersetzt malloc selbst und muss jede Allokation sehen.
+#if defined (__has_feature)
+ #if __has_feature (address_sanitizer)
+  #define ALLOCATION_GUARD_SANITIZED 1
+ #endif
+#endif
+
+#if defined (__SANITIZE_ADDRESS__) && ! defined (ALLOCATION_GUARD_SANITIZED)
+ #define ALLOCATION_GUARD_SANITIZED 1
+#endif
+
+#if ! defined (ALLOCATION_GUARD_SANITIZED) && (JUCE_LINUX || JUCE_MAC || (JUCE_MSVC && defined (_DEBUG)))
+ #define ALLOCATION_GUARD_HOOKS_MALLOC 1
+#else
+ #define ALLOCATION_GUARD_HOOKS_MALLOC 0
+#endif
+
+#if ALLOCATION_GUARD_HOOKS_MALLOC && JUCE_MAC
+ #include <malloc/malloc.h>
+ #include <mach/mach.h>
+ #include <pthread.h>
+#elif ALLOCATION_GUARD_HOOKS_MALLOC && JUCE_MSVC
+ #include <crtdbg.h>
+#endif
+
+namespace
+{
+   #if ALLOCATION_GUARD_HOOKS_MALLOC && JUCE_MAC
+    // Die Zone-Hooks laufen bei jeder Allokation im Prozess, auch während ein Thread
+    // seine thread_local-Variablen anlegt (was selbst allokiert) - Tiefe daher im pthread-Key
+    const pthread_key_t depthKey = []
+    {
+        pthread_key_t key {};
+        pthread_key_create (&key, nullptr);
+        return key;
+    }();
+
+    int getDepth() noexcept             { return (int) (intptr_t) pthread_getspecific (depthKey); }
+    void setDepth (int depth) noexcept  { pthread_setspecific (depthKey, (void*) (intptr_t) depth); }
+   #else
+    thread_local int noAllocationDepth = 0;
+
+    int getDepth() noexcept             { return noAllocationDepth; }
+    void setDepth (int depth) noexcept  { noAllocationDepth = depth; }
+   #endif
+
+    void checkAllocationAllowed() noexcept
+    {
+        if (const int depth = getDepth(); depth > 0)
+        {
+            // Sperre kurz aufheben: jassert selbst darf loggen (und damit allokieren)
+            setDepth (0);
+            jassertfalse; // Allokation auf dem Audio-Thread!
+            setDepth (depth);
+        }
+    }
+
+    void* allocateChecked (std::size_t size)
+    {
+        // Mit Hooks prüft schon malloc - sonst hier
+        if (! ALLOCATION_GUARD_HOOKS_MALLOC)
+            checkAllocationAllowed();
+
+        if (auto* p = std::malloc (size != 0 ? size : 1))
+            return p;
+
+        throw std::bad_alloc();
+    }
+
+    void* allocateAlignedChecked (std::size_t size, std::align_val_t alignment)
+    {
+        // Aligned geht an den malloc-Hooks vorbei
+        checkAllocationAllowed();
+
+        const auto align = juce::jmax ((std::size_t) alignment, sizeof (void*));
+
+       #if JUCE_MSVC
+        if (auto* p = _aligned_malloc (size != 0 ? size : 1, align))
+            return p;
+       #else
+        void* p = nullptr;
+
+        if (posix_memalign (&p, align, size != 0 ? size : 1) == 0)
+            return p;
+       #endif
+
+        throw std::bad_alloc();
+    }
+
+    void freeAligned (void* p) noexcept
+    {
+       #if JUCE_MSVC
+        _aligned_free (p);
+       #else
+        std::free (p);
+       #endif
+    }
+
+   #if ALLOCATION_GUARD_HOOKS_MALLOC && JUCE_MAC
+    using ZoneMalloc  = void* (*) (malloc_zone_t*, size_t);
+    using ZoneCalloc  = void* (*) (malloc_zone_t*, size_t, size_t);
+    using ZoneRealloc = void* (*) (malloc_zone_t*, void*, size_t);
+
+    ZoneMalloc  zoneMalloc  = nullptr;
+    ZoneCalloc  zoneCalloc  = nullptr;
+    ZoneRealloc zoneRealloc = nullptr;
+
+    void* checkedZoneMalloc (malloc_zone_t* zone, size_t size)                { checkAllocationAllowed(); return zoneMalloc (zone, size); }
+    void* checkedZoneCalloc (malloc_zone_t* zone, size_t count, size_t size)  { checkAllocationAllowed(); return zoneCalloc (zone, count, size); }
+    void* checkedZoneRealloc (malloc_zone_t* zone, void* p, size_t size)      { checkAllocationAllowed(); return zoneRealloc (zone, p, size); }
+
+    /** Tauscht die Funktionen der Default-Zone, solange das Binary geladen ist. */
+    struct ZoneHooks
+    {
+        ZoneHooks()   { install (checkedZoneMalloc, checkedZoneCalloc, checkedZoneRealloc, true); }
+        ~ZoneHooks()  { install (zoneMalloc, zoneCalloc, zoneRealloc, false); }   // vor dem Entladen des Plugins
+
+        static void install (ZoneMalloc m, ZoneCalloc c, ZoneRealloc r, bool keepOriginals)
+        {
+            auto* zone = malloc_default_zone();
+
+            if (keepOriginals)
+            {
+                zoneMalloc  = zone->malloc;
+                zoneCalloc  = zone->calloc;
+                zoneRealloc = zone->realloc;
+            }
+
+            // Die Zone ist schreibgeschützt (seit macOS 10.7)
+            const auto address = (vm_address_t) zone;
+            vm_protect (mach_task_self(), address, sizeof (malloc_zone_t), 0, VM_PROT_READ | VM_PROT_WRITE);
+            zone->malloc  = m;
+            zone->calloc  = c;
+            zone->realloc = r;
+            vm_protect (mach_task_self(), address, sizeof (malloc_zone_t), 0, VM_PROT_READ);
+        }
+    };
+
+    const ZoneHooks zoneHooks;
+   #elif ALLOCATION_GUARD_HOOKS_MALLOC && JUCE_MSVC
+    _CRT_ALLOC_HOOK previousAllocHook = nullptr;
+
+    int __cdecl checkCrtAllocation (int type, void* data, size_t size, int blockType, long request,
+                                    const unsigned char* file, int line)
+    {
+        // Interne Blöcke der CRT nicht (Doku: sonst Rekursion)
+        if (blockType != _CRT_BLOCK && (type == _HOOK_ALLOC || type == _HOOK_REALLOC))
+            checkAllocationAllowed();
+
+        return previousAllocHook != nullptr ? previousAllocHook (type, data, size, blockType, request, file, line) : TRUE;
+    }
+
+    struct CrtAllocHook
+    {
+        CrtAllocHook()   { previousAllocHook = _CrtSetAllocHook (checkCrtAllocation); }
+        ~CrtAllocHook()  { _CrtSetAllocHook (previousAllocHook); }
+    };
+
+    const CrtAllocHook crtAllocHook;
+   #endif
+}
+
+#if ALLOCATION_GUARD_HOOKS_MALLOC && JUCE_LINUX
+// Interposer für den Code in diesem Binary (hidden): Host und andere Plugins rufen
+// weiter die glibc direkt. Die __libc_*-Einsprünge sind die unveränderten Originale.
+// Die Sichtbarkeit per .hidden, weil die glibc-Header malloc schon deklarieren.
+__asm__ (".hidden malloc\n\t.hidden calloc\n\t.hidden realloc");
+
+extern "C"
+{
+    void* __libc_malloc (size_t) noexcept;
+    void* __libc_calloc (size_t, size_t) noexcept;
+    void* __libc_realloc (void*, size_t) noexcept;
+
+    void* malloc (size_t size) noexcept
+    {
+        checkAllocationAllowed();
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t count, size_t size) noexcept
+    {
+        checkAllocationAllowed();
+        return __libc_calloc (count, size);
+    }
+
+    void* realloc (void* p, size_t size) noexcept
+    {
+        checkAllocationAllowed();
+        return __libc_realloc (p, size);
+    }
+}
+#endif
+
+AllocationGuard::ScopedNoAllocation::ScopedNoAllocation() noexcept   { setDepth (getDepth() + 1); }
+AllocationGuard::ScopedNoAllocation::~ScopedNoAllocation() noexcept  { setDepth (getDepth() - 1); }
+bool AllocationGuard::isActiveOnThisThread() noexcept               { return getDepth() > 0; }
+
+// Globale Ersetzungen - nur im Debug-Build. Die nothrow-Varianten der Runtime rufen
+// diese auf; aligned Speicher kommt von posix_memalign bzw. _aligned_malloc und wird
+// entsprechend freigegeben.
+void* operator new   (std::size_t size)                                      { return allocateChecked (size); }
+void* operator new[] (std::size_t size)                                      { return allocateChecked (size); }
+void* operator new   (std::size_t size, std::align_val_t alignment)          { return allocateAlignedChecked (size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment)          { return allocateAlignedChecked (size, alignment); }
+void operator delete   (void* p) noexcept                                    { std::free (p); }
+void operator delete[] (void* p) noexcept                                    { std::free (p); }
+void operator delete   (void* p, std::size_t) noexcept                       { std::free (p); }
+void operator delete[] (void* p, std::size_t) noexcept                       { std::free (p); }
+void operator delete   (void* p, std::align_val_t) noexcept                  { freeAligned (p); }
+void operator delete[] (void* p, std::align_val_t) noexcept                  { freeAligned (p); }
+void operator delete   (void* p, std::size_t, std::align_val_t) noexcept     { freeAligned (p); }
+void operator delete[] (void* p, std::size_t, std::align_val_t) noexcept     { freeAligned (p); }
+
+#else
+
+AllocationGuard::ScopedNoAllocation::ScopedNoAllocation() noexcept   {}
+AllocationGuard::ScopedNoAllocation::~ScopedNoAllocation() noexcept  {}
+bool AllocationGuard::isActiveOnThisThread() noexcept               { return false; }
+
+#endif
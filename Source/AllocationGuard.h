@@ -0,0 +1,32 @@
+/*
+==============================================================================
+    AllocationGuard.h
+==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+/**
+    Debug-Hilfe: Solange ein ScopedNoAllocation auf dem aktuellen Thread lebt,
+    löst jede Heap-Allokation ein jassert aus: operator new (auch aligned) sowie
+    malloc/calloc/realloc - unter Linux per Interposer für dieses Binary, unter macOS
+    über die Default-Zone, unter MSVC über den Alloc-Hook der Debug-CRT. Unter ASan
+    bleibt es bei operator new.
+
+    In Release-Builds ist die Klasse leer und kostet nichts.
+*/
+namespace AllocationGuard
+{
+    struct ScopedNoAllocation
+    {
+        ScopedNoAllocation() noexcept;
+        ~ScopedNoAllocation() noexcept;
+
+        ScopedNoAllocation (const ScopedNoAllocation&) = delete;
+        ScopedNoAllocation& operator= (const ScopedNoAllocation&) = delete;
+    };
+
+    /** true, wenn auf diesem Thread gerade Allokationen verboten sind. */
+    bool isActiveOnThisThread() noexcept;
+}
@@ -0,0 +1,155 @@
+/*
+==============================================================================
+    ContentDetectors.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Erkennt echten 5.1-Inhalt auf C/LFE/Ls/Rs - inkrementell und mit Haltezeit.
+
+    Pro Block wird nur jedes stride-te Sample angesehen, der Startversatz
+    wandert von Block zu Block weiter, sodass über stride Blöcke jedes Sample
+    einmal geprüft wird. Der Suchlauf bricht beim ersten Treffer ab.
+
+    Einschalten passiert sofort (echtes 5.1 nie versehentlich upmixen),
+    zurück auf Stereo erst nach holdSeconds ohne Inhalt - ein einzelner
+    stiller Block schaltet also nicht mehr hin und her.
+*/
+class SurroundContentDetector
+{
+public:
+    static constexpr int stride = 8;
+    static constexpr float threshold = 1.0e-5f;
+
+    void prepare (double sampleRate, double holdSeconds = 0.5)
+    {
+        holdSamples = juce::jmax (1, (int) (sampleRate * holdSeconds));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        active = false;
+        samplesWithoutContent = holdSamples;
+        phase = 0;
+    }
+
+    /** Prüft die Kanäle [firstChannel, firstChannel + numChannels) und liefert den Zustand. */
+    bool process (const juce::dsp::AudioBlock<float>& block, int firstChannel, int numChannels) noexcept
+    {
+        const int numSamples = (int) block.getNumSamples();
+        bool found = false;
+
+        for (int ch = firstChannel; ch < firstChannel + numChannels && ! found; ++ch)
+        {
+            const float* data = block.getChannelPointer ((size_t) ch);
+
+            for (int i = phase; i < numSamples; i += stride)
+            {
+                if (std::abs (data[i]) > threshold)
+                {
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        phase = (phase + 1) % stride;
+
+        if (found)
+        {
+            samplesWithoutContent = 0;
+            active = true;
+        }
+        else
+        {
+            samplesWithoutContent = juce::jmin (samplesWithoutContent + numSamples, holdSamples);
+
+            if (samplesWithoutContent >= holdSamples)
+                active = false;
+        }
+
+        return active;
+    }
+
+    bool isActive() const noexcept { return active; }
+
+private:
+    int holdSamples = 1;
+    int samplesWithoutContent = 1;
+    int phase = 0;
+    bool active = false;
+};
+
+//==============================================================================
+/**
+    Leerlauf-Erkennung: Ist der Eingang länger als die Nachklingzeit der Kette
+    (Surround-Delay + Limiter-Release) still, kann die DSP-Kette komplett
+    übersprungen und einfach Stille ausgegeben werden.
+
+    Die Prüfung läuft in kleinen Stücken und bricht beim ersten hörbaren
+    Sample ab - bei normalem Material kostet sie praktisch nichts.
+*/
+class SilenceIdleGate
+{
+public:
+    static constexpr float threshold = 1.0e-5f; // -100 dBFS
+
+    void prepare (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset() noexcept   { silentSamples = 0; }
+
+    void setTailSeconds (double seconds) noexcept
+    {
+        tailSamples = (juce::int64) std::ceil (seconds * sampleRate);
+    }
+
+    /** true => Block überspringen und Nullen schreiben. */
+    bool process (const juce::dsp::AudioBlock<float>& block, int numInputChannels) noexcept
+    {
+        const int numSamples = (int) block.getNumSamples();
+
+        for (int ch = 0; ch < numInputChannels; ++ch)
+        {
+            if (! isSilent (block.getChannelPointer ((size_t) ch), numSamples))
+            {
+                silentSamples = 0;
+                return false;
+            }
+        }
+
+        // Leerlauf erst, wenn die Stille VOR diesem Block schon länger als der Tail war
+        const bool idle = silentSamples >= tailSamples;
+        silentSamples += numSamples;
+        return idle;
+    }
+
+private:
+    static bool isSilent (const float* data, int numSamples) noexcept
+    {
+        constexpr int chunk = 64;
+
+        for (int start = 0; start < numSamples; start += chunk)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax (data + start, juce::jmin (chunk, numSamples - start));
+
+            if (range.getStart() < -threshold || range.getEnd() > threshold)
+                return false;
+        }
+
+        return true;
+    }
+
+    double sampleRate = 44100.0;
+    juce::int64 tailSamples = 0;
+    juce::int64 silentSamples = 0;
+};
@@ -0,0 +1,185 @@
+/*
+==============================================================================
+    LevelMeter.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "UpmixKernels.h"
+#include "OutputLayout.h"
+
+//==============================================================================
+/** Ein konsistenter Satz Meterwerte für alle Ausgänge, in Kanalreihenfolge des Hosts.
+    Die Rolle pro Kanal reist mit, damit der Editor Beschriftung und Anzahl kennt.
+*/
+struct MeterSnapshot
+{
+    static constexpr int maxChannels = OutputLayout::maxChannels;
+
+    struct Channel
+    {
+        float rms      = 0.0f;
+        float peak     = 0.0f;
+        float peakHold = 0.0f;
+        OutputLayout::Role role = OutputLayout::numRoles;
+    };
+
+    int numChannels = 0;
+    std::array<Channel, maxChannels> channels {};
+};
+
+//==============================================================================
+/**
+    Triple-Buffer für genau einen Schreiber (Audio-Thread) und einen Leser
+    (Editor-Timer). Beide Seiten sind wait-free, der Leser sieht immer einen
+    vollständigen Snapshot - nie eine Mischung aus zwei Blöcken.
+
+    Drei Slots: der Schreiber füllt "back" und tauscht ihn mit "middle",
+    der Leser tauscht "front" mit "middle", wenn ein neuer Stand markiert ist.
+*/
+class MeterSnapshotBuffer
+{
+public:
+    /** Audio-Thread. */
+    void publish (const MeterSnapshot& snapshot) noexcept
+    {
+        slots[backIndex] = snapshot;
+        const int previous = middle.exchange (backIndex | newDataFlag, std::memory_order_acq_rel);
+        backIndex = previous & indexMask;
+    }
+
+    /** Editor. Liefert false, wenn seit dem letzten Aufruf nichts Neues kam. */
+    bool read (MeterSnapshot& result) noexcept
+    {
+        if ((middle.load (std::memory_order_relaxed) & newDataFlag) == 0)
+            return false;
+
+        const int previous = middle.exchange (frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & indexMask;
+        result = slots[frontIndex];
+        return true;
+    }
+
+private:
+    static constexpr int newDataFlag = 4;
+    static constexpr int indexMask   = 3;
+
+    std::array<MeterSnapshot, 3> slots {};
+    std::atomic<int> middle { 1 };
+    int backIndex  = 0;   // gehört dem Audio-Thread
+    int frontIndex = 2;   // gehört dem Editor
+
+    static_assert (std::atomic<int>::is_always_lock_free);
+};
+
+//==============================================================================
+/**
+    Sammelt auf dem Audio-Thread echte RMS- und Spitzenwerte über ein festes
+    Fenster (unabhängig von der Host-Blockgröße) und veröffentlicht nach jedem
+    vollen Fenster einen Snapshot. Peak-Hold hält den höchsten Wert für
+    holdSeconds und fällt dann auf die aktuelle Spitze zurück.
+*/
+class LevelMeterAccumulator
+{
+public:
+    /** Misst die Kanäle von layout - Kosten wachsen nur mit deren Anzahl. */
+    void prepare (double sampleRate, const OutputLayout& layout, double windowSeconds = 0.05, double holdSeconds = 1.5)
+    {
+        windowSamples = juce::jmax (1, (int) (sampleRate * windowSeconds));
+        holdSamples   = juce::jmax (1, (int) (sampleRate * holdSeconds));
+        numMeteredChannels = juce::jmin (layout.numChannels, MeterSnapshot::maxChannels);
+        reset();
+
+        current.numChannels = numMeteredChannels;
+
+        for (int ch = 0; ch < numMeteredChannels; ++ch)
+            current.channels[(size_t) ch].role = layout.getRole (ch);
+    }
+
+    void reset() noexcept
+    {
+        sumOfSquares.fill (0.0);
+        peaks.fill (0.0f);
+        holdAge.fill (0);
+
+        for (auto& c : current.channels)
+            c.rms = c.peak = c.peakHold = 0.0f;
+
+        accumulatedSamples = 0;
+    }
+
+    /** Ein Durchlauf pro Kanal; fehlende Kanäle zählen als Stille. */
+    void process (const juce::dsp::AudioBlock<const float>& block, MeterSnapshotBuffer& target) noexcept
+    {
+        const int numSamples  = (int) block.getNumSamples();
+        const int numChannels = juce::jmin ((int) block.getNumChannels(), numMeteredChannels);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            UpmixKernels::measureLevel (block.getChannelPointer ((size_t) ch), numSamples,
+                                        sumOfSquares[(size_t) ch], peaks[(size_t) ch]);
+
+        addSamples (numSamples, target);
+    }
+
+    /** Für eine Stufe, die beim Schreiben selbst misst (LookaheadLimiter::process):
+        die Akkumulatoren der gemessenen Kanäle. Danach addMeasuredSamples aufrufen.
+    */
+    UpmixKernels::LevelAccumulators getAccumulators() noexcept
+    {
+        return { sumOfSquares.data(), peaks.data(), numMeteredChannels };
+    }
+
+    /** Schließt einen über getAccumulators gemessenen Block ab. */
+    void addMeasuredSamples (int numSamples, MeterSnapshotBuffer& target) noexcept
+    {
+        addSamples (numSamples, target);
+    }
+
+    /** Für übersprungene (stille) Blöcke: zählt nur die Zeit weiter. */
+    void processSilence (int numSamples, MeterSnapshotBuffer& target) noexcept
+    {
+        addSamples (numSamples, target);
+    }
+
+private:
+    void addSamples (int numSamples, MeterSnapshotBuffer& target) noexcept
+    {
+        accumulatedSamples += numSamples;
+
+        if (accumulatedSamples < windowSamples)
+            return;
+
+        for (size_t ch = 0; ch < (size_t) numMeteredChannels; ++ch)
+        {
+            auto& c = current.channels[ch];
+            c.rms  = (float) std::sqrt (sumOfSquares[ch] / accumulatedSamples);
+            c.peak = peaks[ch];
+
+            holdAge[ch] += accumulatedSamples;
+
+            if (c.peak >= c.peakHold || holdAge[ch] >= holdSamples)
+            {
+                c.peakHold  = c.peak;
+                holdAge[ch] = 0;
+            }
+
+            sumOfSquares[ch] = 0.0;
+            peaks[ch] = 0.0f;
+        }
+
+        accumulatedSamples = 0;
+        target.publish (current);
+    }
+
+    std::array<double, MeterSnapshot::maxChannels> sumOfSquares {};
+    std::array<float,  MeterSnapshot::maxChannels> peaks {};
+    std::array<int,    MeterSnapshot::maxChannels> holdAge {};
+    MeterSnapshot current;
+    int numMeteredChannels = 0;
+
+    int windowSamples = 1;
+    int holdSamples   = 1;
+    int accumulatedSamples = 0;
+};
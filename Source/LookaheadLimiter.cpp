@@ -0,0 +1,217 @@
+/*
+==============================================================================
+    LookaheadLimiter.cpp
+==============================================================================
+*/
+
+#include "LookaheadLimiter.h"
+
+#include <cstring>
+
+//==============================================================================
+void LookaheadLimiter::prepare (double sampleRate, int maximumBlockSize, int numChannelsToUse, float lookaheadMs, float releaseMs)
+{
+    jassert (numChannelsToUse > 0 && numChannelsToUse <= maxChannels);
+
+    numChannels  = numChannelsToUse;
+    maxChunk     = juce::jmax (1, maximumBlockSize);
+    windowLength = juce::jmax (1, juce::roundToInt (lookaheadMs * sampleRate / 1000.0));
+    delaySamples = windowLength - 1 + UpmixKernels::truePeakTaps / 2;
+    invWindowLength = 1.0 / (double) windowLength;
+
+    releaseCoefficient = (float) (1.0 - std::exp (-1.0 / (releaseMs * sampleRate / 1000.0)));
+
+    // True-Peak lässt sich per Parameter jederzeit einschalten - Tabelle also schon hier bauen
+    UpmixKernels::prepareTruePeak();
+
+    const int dequeCapacity = juce::nextPowerOfTwo (windowLength + 1);
+    dequeValues.assign ((size_t) dequeCapacity, 0.0f);
+    dequeIndices.assign ((size_t) dequeCapacity, 0);
+    dequeMask = dequeCapacity - 1;
+
+    boxRing.assign ((size_t) windowLength, 1.0f);
+
+    history.prepare (numChannels, UpmixKernels::truePeakTaps - 1 + maxChunk);
+    delay.prepare (numChannels, delaySamples);
+    detector.prepare (2, maxChunk);
+
+    reset();
+}
+
+void LookaheadLimiter::reset() noexcept
+{
+    delay.clear (0, numChannels, delay.getMaxSamples());
+    delayPosition = 0;
+
+    resetDetector();
+}
+
+void LookaheadLimiter::resetDetector() noexcept
+{
+    history.clear (0, numChannels, history.getMaxSamples());
+
+    dequeHead = 0;
+    dequeSize = 0;
+    sampleCounter = 0;
+    envelope = 1.0f;
+
+    std::fill (boxRing.begin(), boxRing.end(), 1.0f);
+    boxPosition = 0;
+    boxSum = (double) windowLength;
+
+    detectorStale = false;
+}
+
+void LookaheadLimiter::primeDetector() noexcept
+{
+    // Der Ring hält die letzten delaySamples Eingangssamples, das älteste bei delayPosition.
+    // Ihr Gain steht noch aus: frisch aufsetzen und sie in Reihenfolge durch den Detektor
+    // schicken. Was davor lag, ist ungedämpft längst am Ausgang.
+    resetDetector();
+
+    float* ringChannels[maxChannels] {};
+
+    for (int done = 0; done < delaySamples;)
+    {
+        const int position = (delayPosition + done) % delaySamples;
+        const int n = juce::jmin (maxChunk, delaySamples - done, delaySamples - position);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            ringChannels[ch] = delay.getChannel (ch) + position;
+
+        detect (juce::dsp::AudioBlock<float> (ringChannels, (size_t) numChannels, (size_t) n));
+        done += n;
+    }
+}
+
+//==============================================================================
+void LookaheadLimiter::process (const juce::dsp::AudioBlock<float>& block, UpmixKernels::LevelAccumulators levels) noexcept
+{
+    if (detectorStale)
+        primeDetector();
+
+    const int numSamples = (int) block.getNumSamples();
+
+    for (int start = 0; start < numSamples; start += maxChunk)
+    {
+        const auto chunk = block.getSubBlock ((size_t) start, (size_t) juce::jmin (maxChunk, numSamples - start));
+        const float minGain = detect (chunk);
+
+        // Bleibt der Gain im ganzen Teilblock bei 1, entfällt die Multiplikation
+        delayAndApplyGain (chunk, minGain < 1.0f ? detector.getChannel (1) : nullptr, levels);
+    }
+}
+
+void LookaheadLimiter::processDelayOnly (const juce::dsp::AudioBlock<float>& block, UpmixKernels::LevelAccumulators levels) noexcept
+{
+    delayAndApplyGain (block, nullptr, levels);
+    detectorStale = true;
+}
+
+float LookaheadLimiter::detect (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    constexpr int historyLength = UpmixKernels::truePeakTaps - 1;
+
+    const int numSamples = (int) block.getNumSamples();
+    const int channels   = juce::jmin (numChannels, (int) block.getNumChannels());
+
+    float* peak = detector.getChannel (0);
+    float* gain = detector.getChannel (1);
+    juce::FloatVectorOperations::clear (peak, numSamples);
+
+    // 1) Gelinkte Spitzenwerte, um die halbe Interpolatorlänge verzögert
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* h = history.getChannel (ch);
+        juce::FloatVectorOperations::copy (h + historyLength, block.getChannelPointer ((size_t) ch), numSamples);
+
+        if (truePeak)
+            UpmixKernels::accumulateTruePeak (h, peak, numSamples);
+        else
+            UpmixKernels::accumulatePeak (h + historyLength - UpmixKernels::truePeakTaps / 2, peak, numSamples);
+
+        std::memmove (h, h + numSamples, sizeof (float) * (size_t) historyLength);
+    }
+
+    // 2) Deque, Release und Mittelwert - der einzige serielle Teil, einmal für alle Kanäle
+    float minGain = 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        gain[i] = detectAndSmooth (peak[i]);
+        minGain = juce::jmin (minGain, gain[i]);
+    }
+
+    return minGain;
+}
+
+float LookaheadLimiter::detectAndSmooth (float peak) noexcept
+{
+    // Monotone Deque: hinten alles verwerfen, was nie mehr Maximum werden kann ...
+    while (dequeSize > 0 && dequeValues[(size_t) ((dequeHead + dequeSize - 1) & dequeMask)] <= peak)
+        --dequeSize;
+
+    const int back = (dequeHead + dequeSize) & dequeMask;
+    dequeValues[(size_t) back]  = peak;
+    dequeIndices[(size_t) back] = sampleCounter;
+    ++dequeSize;
+
+    // ... vorn fällt pro Sample höchstens ein Eintrag aus dem Fenster
+    if (sampleCounter - dequeIndices[(size_t) dequeHead] >= (juce::uint32) windowLength)
+    {
+        dequeHead = (dequeHead + 1) & dequeMask;
+        --dequeSize;
+    }
+
+    ++sampleCounter;
+
+    const float windowMax = dequeValues[(size_t) dequeHead];
+    const float target = windowMax > ceiling ? ceiling / windowMax : 1.0f;
+
+    // Sofortiger Attack, Release nähert sich von unten - bleibt also immer <= target
+    envelope = target < envelope ? target : envelope + releaseCoefficient * (target - envelope);
+
+    boxSum += (double) envelope - (double) boxRing[(size_t) boxPosition];
+    boxRing[(size_t) boxPosition] = envelope;
+
+    if (++boxPosition == windowLength)
+        boxPosition = 0;
+
+    return juce::jmin (1.0f, (float) (boxSum * invWindowLength));
+}
+
+void LookaheadLimiter::delayAndApplyGain (const juce::dsp::AudioBlock<float>& block, const float* gain,
+                                          UpmixKernels::LevelAccumulators levels) noexcept
+{
+    const int numSamples = (int) block.getNumSamples();
+    const int channels   = juce::jmin (numChannels, (int) block.getNumChannels());
+
+    // 3) Verzögern (Ring in Segmenten bis zum Ende), Gain anwenden und messen - ein Durchlauf
+    int position = delayPosition;
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* data = block.getChannelPointer ((size_t) ch);
+        float* ring = delay.getChannel (ch);
+        const bool measured = ch < levels.numChannels;
+        position = delayPosition;
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int n = juce::jmin (numSamples - done, delaySamples - position);
+
+            UpmixKernels::delayApplyGain (data + done, ring + position,
+                                          gain != nullptr ? gain + done : nullptr, n,
+                                          measured ? levels.sumOfSquares + ch : nullptr,
+                                          measured ? levels.peaks + ch : nullptr);
+
+            done += n;
+            position += n;
+
+            if (position == delaySamples)
+                position = 0;
+        }
+    }
+
+    delayPosition = channels > 0 ? position : (delayPosition + numSamples) % delaySamples;
+}
@@ -0,0 +1,96 @@
+/*
+==============================================================================
+    LookaheadLimiter.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "ScratchArena.h"
+#include "UpmixKernels.h"
+
+//==============================================================================
+/**
+    Gelinkter Brickwall-Limiter mit Lookahead für alle Ausgangskanäle.
+
+    Detektor: Spitzenwert über alle Kanäle (optional True-Peak per 4x-
+    Polyphasen-Interpolation), Fenstermaximum über die Lookahead-Länge mit
+    einer monotonen Deque - O(1) pro Sample, unabhängig von der Länge.
+    Daraus der nötige Gain, sofortiger Attack, exponentieller Release und
+    ein gleitender Mittelwert über die Lookahead-Länge: Der Gain hat sein
+    Minimum genau dann erreicht, wenn die verzögerte Spitze am Ausgang ankommt.
+
+    Nur der Detektor-Loop ist seriell (einmal pro Sample, nicht pro Kanal).
+    Spitzenwerte, Verzögerung und Gain laufen vektorisiert pro Kanal; bleibt
+    der Gain im ganzen Block bei 1, entfällt die Multiplikation. Der Limiter
+    schreibt als Letzter: Auf Wunsch misst er im selben Durchlauf auch gleich
+    RMS und Spitze für das Meter.
+
+    Die Latenz ist in beiden Detektor-Modi gleich (Lookahead + halbe
+    Interpolatorlänge), damit ein Umschalten den Host nicht neu kompensieren lässt.
+
+    processDelayOnly ist nur die Verzögerung (Pass-Through, Bypass): ein Tausch
+    mit dem Ring, kein Detektor. Der nächste process-Aufruf liest den Ring einmal
+    nach - genau die Samples, deren Gain noch aussteht - und setzt ohne Sprung ein.
+*/
+class LookaheadLimiter
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    LookaheadLimiter() = default;
+
+    /** Allokiert Verzögerung, Historie und Detektorpuffer. */
+    void prepare (double sampleRate, int maximumBlockSize, int numChannelsToUse, float lookaheadMs, float releaseMs);
+    void reset() noexcept;
+
+    void setCeilingDecibels (float ceilingDb) noexcept   { ceiling = juce::Decibels::decibelsToGain (ceilingDb); }
+    void setTruePeak (bool shouldUseTruePeak) noexcept   { truePeak = shouldUseTruePeak; }
+
+    int getLatencySamples() const noexcept                { return delaySamples; }
+
+    /** In-place. levels: Quadratsummen und Spitzen des Ausgangs werden dort pro Kanal aufaddiert. */
+    void process (const juce::dsp::AudioBlock<float>& block, UpmixKernels::LevelAccumulators levels = {}) noexcept;
+
+    /** In-place, nur um getLatencySamples() verzögert - ohne Detektor und ohne Gain. */
+    void processDelayOnly (const juce::dsp::AudioBlock<float>& block, UpmixKernels::LevelAccumulators levels = {}) noexcept;
+
+private:
+    void resetDetector() noexcept;
+    void primeDetector() noexcept;
+    float detect (const juce::dsp::AudioBlock<float>& block) noexcept;
+    float detectAndSmooth (float peak) noexcept;
+    void delayAndApplyGain (const juce::dsp::AudioBlock<float>& block, const float* gain, UpmixKernels::LevelAccumulators levels) noexcept;
+
+    int numChannels  = 0;
+    int maxChunk     = 0;
+    int windowLength = 1;    // Lookahead in Samples
+    int delaySamples = 0;    // windowLength - 1 + Gruppenlaufzeit des Interpolators
+    int delayPosition = 0;
+
+    float ceiling = 1.0f;
+    float releaseCoefficient = 0.0f;
+    bool truePeak = false;
+    bool detectorStale = false;   // nach processDelayOnly: Ring vor dem nächsten process nachlesen
+
+    // Monotone Deque (Ring, Größe Zweierpotenz): Werte fallend von vorn nach hinten
+    std::vector<float> dequeValues;
+    std::vector<juce::uint32> dequeIndices;
+    int dequeMask = 0, dequeHead = 0, dequeSize = 0;
+    juce::uint32 sampleCounter = 0;
+
+    float envelope = 1.0f;
+
+    // Gleitender Mittelwert über windowLength Samples
+    std::vector<float> boxRing;
+    int boxPosition = 0;
+    double boxSum = 0.0;
+    double invWindowLength = 1.0;
+
+    ScratchArena history;   // pro Kanal truePeakTaps - 1 alte + maxChunk neue Samples
+    ScratchArena delay;     // pro Kanal ein Ring mit delaySamples
+    ScratchArena detector;  // 0 = Spitzenwerte, 1 = Gain pro Sample
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LookaheadLimiter)
+};
@@ -0,0 +1,129 @@
+/*
+==============================================================================
+    OutputLayout.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/**
+    Welche Rolle auf welchem Ausgangskanal liegt - für Stereo, 5.1, 7.1 und 7.1.4.
+
+    Die Kette schreibt nie auf feste Indizes, sondern fragt hier nach: Die
+    Reihenfolge kommt vom Host (JUCE sortiert nach ChannelType, bei 7.1.4 liegen
+    die Höhen also VOR den hinteren Surrounds). Rollen, die das Format nicht
+    hat, stehen auf -1.
+*/
+struct OutputLayout
+{
+    enum Role
+    {
+        left = 0,
+        right,
+        centre,
+        lfe,
+        surroundLeft,       // 5.1: Ls/Rs, 7.1: Seiten-Surrounds
+        surroundRight,
+        rearLeft,           // ab 7.1
+        rearRight,
+        topFrontLeft,       // 7.1.4
+        topFrontRight,
+        topRearLeft,
+        topRearRight,
+        numRoles
+    };
+
+    static constexpr int maxChannels = numRoles;
+
+    int numChannels = 6;
+    std::array<int, numRoles> channelIndex { 0, 1, 2, 3, 4, 5, -1, -1, -1, -1, -1, -1 };
+
+    bool has (Role role) const noexcept                  { return channelIndex[(size_t) role] >= 0; }
+    int getChannelIndex (Role role) const noexcept       { return channelIndex[(size_t) role]; }
+
+    /** Rolle des Kanals (Umkehrung von getChannelIndex), numRoles für unbekannte Kanäle. */
+    Role getRole (int channel) const noexcept
+    {
+        for (int r = 0; r < numRoles; ++r)
+            if (channelIndex[(size_t) r] == channel)
+                return (Role) r;
+
+        return numRoles;
+    }
+
+    static const char* getShortName (Role role) noexcept
+    {
+        static constexpr const char* names[] = { "L", "R", "C", "LFE", "Ls", "Rs", "Lrs", "Rrs", "Ltf", "Rtf", "Ltr", "Rtr", "" };
+        return names[(size_t) juce::jlimit (0, (int) numRoles, (int) role)];
+    }
+
+    //==============================================================================
+    /** Aus dem Kanal-Set des Hosts. Sets ohne die 5.1-Kanäle (siehe isBusesLayoutSupported)
+        werden wie das Standard-Set derselben Breite gelesen, andere Breiten als 5.1.
+    */
+    static OutputLayout fromChannelSet (const juce::AudioChannelSet& set)
+    {
+        using CT = juce::AudioChannelSet::ChannelType;
+
+        OutputLayout layout;
+        layout.numChannels = set.size();
+
+        auto indexOf = [&set] (CT primary, CT alternative)
+        {
+            const int index = set.getChannelIndexForType (primary);
+            return index >= 0 ? index : set.getChannelIndexForType (alternative);
+        };
+
+        // Stereo hat nur L/R; 5.1 nennt die Surrounds leftSurround, 7.1 leftSurroundSide
+        layout.channelIndex = { indexOf (CT::left, CT::left),
+                                indexOf (CT::right, CT::right),
+                                indexOf (CT::centre, CT::centre),
+                                indexOf (CT::LFE, CT::LFE),
+                                indexOf (CT::leftSurroundSide, CT::leftSurround),
+                                indexOf (CT::rightSurroundSide, CT::rightSurround),
+                                indexOf (CT::leftSurroundRear, CT::leftSurroundRear),
+                                indexOf (CT::rightSurroundRear, CT::rightSurroundRear),
+                                indexOf (CT::topFrontLeft, CT::topFrontLeft),
+                                indexOf (CT::topFrontRight, CT::topFrontRight),
+                                indexOf (CT::topRearLeft, CT::topRearLeft),
+                                indexOf (CT::topRearRight, CT::topRearRight) };
+
+        // Sonst blieben Kanäle ungeschrieben: ein 12-Kanal-Set ohne Rollennamen z.B. als 7.1.4
+        if (layout.numChannels > 2 && ! layout.isSurround())
+            return fromChannelSet (getChannelSet (layout.numChannels));
+
+        return layout;
+    }
+
+    /** Für Tools ohne Host: 2, 6, 8, 12 Kanäle = Stereo, 5.1, 7.1, 7.1.4 in JUCE-Reihenfolge
+        (andere Breiten: 5.1).
+    */
+    static OutputLayout fromNumChannels (int numChannels)
+    {
+        return fromChannelSet (getChannelSet (numChannels));
+    }
+
+    static juce::AudioChannelSet getChannelSet (int numChannels)
+    {
+        switch (numChannels)
+        {
+            case 2:  return juce::AudioChannelSet::stereo();
+            case 8:  return juce::AudioChannelSet::create7point1();
+            case 12: return juce::AudioChannelSet::create7point1point4();
+            default: return juce::AudioChannelSet::create5point1();
+        }
+    }
+
+    /** Hat das Layout alles, was der Upmix mindestens schreibt (5.1)? */
+    bool isSurround() const noexcept
+    {
+        for (auto role : { left, right, centre, lfe, surroundLeft, surroundRight })
+            if (! has (role))
+                return false;
+
+        return true;
+    }
+};
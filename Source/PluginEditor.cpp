@@ -9,8 +9,7 @@
 
 //==============================================================================
 CoherentUpmixAudioProcessorEditor::CoherentUpmixAudioProcessorEditor (CoherentUpmixAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p),
-      meterL("L"), meterR("R"), meterC("C"), meterLFE("LFE"), meterLs("Ls"), meterRs("Rs")
+    : AudioProcessorEditor (&p), audioProcessor (p)
 {
     setLookAndFeel(&modernLook);
 
@@ -30,6 +29,8 @@ CoherentUpmixAudioProcessorEditor::CoherentUpmixAudioProcessorEditor (CoherentUp
     modeSelector.addItem("Modern Transient", 4);  // War bisher "Exact Downmix"
     modeSelector.addItem("Exact Downmix", 5);     // Verschoben
     modeSelector.addItem("5.1 Pass-Through", 6);  // ← NEU HINZUFÜGEN
+    modeSelector.addItem("Spectral Upmix", 7);
+    modeSelector.addItem("Zero-Latency PCA", 8);
     
     modeLabel.setText("ALGORITHM", juce::dontSendNotification);
     modeLabel.setJustificationType(juce::Justification::centred);
@@ -62,13 +63,14 @@ CoherentUpmixAudioProcessorEditor::CoherentUpmixAudioProcessorEditor (CoherentUp
     presetLabel.attachToComponent(&presetSelector, true);
     addAndMakeVisible(presetLabel);
 
-    // --- METERS ---
-    addAndMakeVisible(meterL);
-    addAndMakeVisible(meterR);
-    addAndMakeVisible(meterC);
-    addAndMakeVisible(meterLFE);
-    addAndMakeVisible(meterLs);
-    addAndMakeVisible(meterRs);
+    // --- METERS --- bis der erste Snapshot kommt, nach dem aktuellen Bus-Layout
+    const auto outputLayout = OutputLayout::fromChannelSet (p.getChannelLayoutOfBus (false, 0));
+    meterSnapshot.numChannels = juce::jmin (outputLayout.numChannels, MeterSnapshot::maxChannels);
+
+    for (int ch = 0; ch < meterSnapshot.numChannels; ++ch)
+        meterSnapshot.channels[(size_t) ch].role = outputLayout.getRole (ch);
+
+    rebuildMeters();
 
     // --- ATTACHMENTS ---
     // Attachments müssen NACH dem Setup der Komponenten erstellt werden.
@@ -84,13 +86,12 @@ CoherentUpmixAudioProcessorEditor::CoherentUpmixAudioProcessorEditor (CoherentUp
     modeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(vts, "processingMode", modeSelector);
     loudnessAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(vts, "loudnessBoost", loudnessButton);
 
+    setOpaque (true);
     setSize (800, 450);
-    startTimerHz(60);
 }
 
 CoherentUpmixAudioProcessorEditor::~CoherentUpmixAudioProcessorEditor()
 {
-    stopTimer();
     setLookAndFeel(nullptr);
 }
 
@@ -99,39 +100,61 @@ CoherentUpmixAudioProcessorEditor::~CoherentUpmixAudioProcessorEditor()
 
 void CoherentUpmixAudioProcessorEditor::paint (juce::Graphics& g)
 {
-    g.fillAll (findColour(juce::ResizableWindow::backgroundColourId));
+    // Der Hintergrund ist statisch - nur bei neuer Größe oder Skalierung neu rendern
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (backgroundImage.isNull() || scale != backgroundScale)
+        renderBackground (scale);
+
+    g.drawImage (backgroundImage, getLocalBounds().toFloat());
+}
+
+void CoherentUpmixAudioProcessorEditor::renderBackground (float scale)
+{
+    backgroundScale = scale;
+    backgroundImage = juce::Image (juce::Image::RGB,
+                                   juce::jmax (1, juce::roundToInt ((float) getWidth() * scale)),
+                                   juce::jmax (1, juce::roundToInt ((float) getHeight() * scale)),
+                                   false);
+
+    juce::Graphics bg (backgroundImage);
+    bg.addTransform (juce::AffineTransform::scale (scale));
+
+    bg.fillAll (findColour(juce::ResizableWindow::backgroundColourId));
     juce::Rectangle<float> headerArea (0, 0, getWidth(), 50);
-    g.setColour(juce::Colour::fromString("ff181818"));
-    g.fillRect(headerArea);
-    g.setColour(juce::Colours::white.withAlpha(0.1f));
-    g.drawHorizontalLine(50, 0.0f, (float)getWidth());
-    g.setColour(juce::Colours::white.withAlpha(0.9f));
-    g.setFont(juce::Font(juce::FontOptions("Roboto", 22.0f, juce::Font::bold)));
-    g.drawText("COHERENT UPMIX 5.1", 20, 0, 300, 50, juce::Justification::centredLeft);
-    g.setColour(findColour(juce::Slider::thumbColourId));
-    g.setFont(14.0f);
-    g.drawText("PRO EDITION", 230, 0, 100, 50, juce::Justification::centredLeft);
+    bg.setColour(juce::Colour::fromString("ff181818"));
+    bg.fillRect(headerArea);
+    bg.setColour(juce::Colours::white.withAlpha(0.1f));
+    bg.drawHorizontalLine(50, 0.0f, (float)getWidth());
+    bg.setColour(juce::Colours::white.withAlpha(0.9f));
+    bg.setFont(juce::Font(juce::FontOptions("Roboto", 22.0f, juce::Font::bold)));
+    bg.drawText("COHERENT UPMIX 5.1", 20, 0, 300, 50, juce::Justification::centredLeft);
+    bg.setColour(findColour(juce::Slider::thumbColourId));
+    bg.setFont(14.0f);
+    bg.drawText("PRO EDITION", 230, 0, 100, 50, juce::Justification::centredLeft);
     auto area = getLocalBounds().toFloat();
     area.removeFromTop(60);
     area.removeFromBottom(60);
-    auto rightArea = area.removeFromRight(180);
+    auto rightArea = area.removeFromRight(getMeterPanelWidth());
     auto mainArea = area.reduced(10);
-    g.setColour(juce::Colour::fromString("ff222222"));
-    g.fillRoundedRectangle(mainArea, 8.0f);
-    g.setColour(juce::Colours::black.withAlpha(0.3f));
-    g.drawRoundedRectangle(mainArea, 8.0f, 1.0f);
+    bg.setColour(juce::Colour::fromString("ff222222"));
+    bg.fillRoundedRectangle(mainArea, 8.0f);
+    bg.setColour(juce::Colours::black.withAlpha(0.3f));
+    bg.drawRoundedRectangle(mainArea, 8.0f, 1.0f);
     auto meterBg = rightArea.reduced(10, 0);
-    g.setColour(juce::Colour::fromString("ff121212"));
-    g.fillRoundedRectangle(meterBg, 8.0f);
-    g.setColour(juce::Colours::white.withAlpha(0.1f));
-    g.drawRoundedRectangle(meterBg, 8.0f, 1.0f);
-    g.setColour(juce::Colours::grey);
-    g.setFont(12.0f);
-    g.drawText("OUTPUT", meterBg.removeFromTop(20), juce::Justification::centred, false);
+    bg.setColour(juce::Colour::fromString("ff121212"));
+    bg.fillRoundedRectangle(meterBg, 8.0f);
+    bg.setColour(juce::Colours::white.withAlpha(0.1f));
+    bg.drawRoundedRectangle(meterBg, 8.0f, 1.0f);
+    bg.setColour(juce::Colours::grey);
+    bg.setFont(12.0f);
+    bg.drawText("OUTPUT", meterBg.removeFromTop(20), juce::Justification::centred, false);
 }
 
 void CoherentUpmixAudioProcessorEditor::resized()
 {
+    backgroundImage = {};
+
     auto area = getLocalBounds();
     auto header = area.removeFromTop(50);
     presetSelector.setBounds(header.removeFromRight(200).reduced(10, 10));
@@ -143,15 +166,11 @@ void CoherentUpmixAudioProcessorEditor::resized()
     modeSelector.setBounds(leftFooter.reduced(0, 5));
     footer.removeFromLeft(20);
     loudnessButton.setBounds(footer.removeFromLeft(buttonWidth).reduced(0, 5));
-    auto meterArea = area.removeFromRight(180).reduced(20, 20);
+    auto meterArea = area.removeFromRight(getMeterPanelWidth()).reduced(20, 20);
     meterArea.removeFromTop(20);
-    int meterWidth = meterArea.getWidth() / 6;
-    meterL.setBounds(meterArea.removeFromLeft(meterWidth).reduced(2, 0));
-    meterR.setBounds(meterArea.removeFromLeft(meterWidth).reduced(2, 0));
-    meterC.setBounds(meterArea.removeFromLeft(meterWidth).reduced(2, 0));
-    meterLFE.setBounds(meterArea.removeFromLeft(meterWidth).reduced(2, 0));
-    meterLs.setBounds(meterArea.removeFromLeft(meterWidth).reduced(2, 0));
-    meterRs.setBounds(meterArea.removeFromLeft(meterWidth).reduced(2, 0));
+    int meterWidth = meterArea.getWidth() / juce::jmax(1, meters.size());
+    for (auto* meter : meters)
+        meter->setBounds(meterArea.removeFromLeft(meterWidth).reduced(2, 0));
     auto sliderArea = area.reduced(20);
     int sliderW = sliderArea.getWidth() / 5;
     surroundBalanceSlider.setBounds(sliderArea.removeFromLeft(sliderW).reduced(5));
@@ -176,14 +195,43 @@ void CoherentUpmixAudioProcessorEditor::setupSlider (juce::Slider& slider, juce:
     addAndMakeVisible (label);
 }
 
-void CoherentUpmixAudioProcessorEditor::timerCallback()
+void CoherentUpmixAudioProcessorEditor::updateMeters()
+{
+    // Glättung wie bisher (30 % pro 60-Hz-Frame), aber unabhängig von der Bildwiederholrate
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const double frameSeconds = juce::jlimit (0.0, 0.1, (now - lastMeterUpdateMs) * 0.001);
+    lastMeterUpdateMs = now;
+    const float smoothing = 1.0f - std::pow (0.7f, (float) (frameSeconds * 60.0));
+
+    // Ein konsistenter Snapshot für alle Kanäle; ohne neue Daten bleibt der letzte stehen
+    audioProcessor.getMeterSnapshots().read (meterSnapshot);
+
+    bool layoutChanged = meterSnapshot.numChannels != meters.size();
+
+    for (int ch = 0; ch < meterSnapshot.numChannels && ! layoutChanged; ++ch)
+        layoutChanged = meterSnapshot.channels[(size_t) ch].role != meterRoles[(size_t) ch];
+
+    if (layoutChanged)
+        rebuildMeters();
+
+    for (int ch = 0; ch < meters.size(); ++ch)
+        meters[ch]->setLevel (meterSnapshot.channels[(size_t) ch].rms, meterSnapshot.channels[(size_t) ch].peakHold, smoothing);
+}
+
+void CoherentUpmixAudioProcessorEditor::rebuildMeters()
 {
-    meterL.setLevel(audioProcessor.rmsLevelLeft.load());
-    meterR.setLevel(audioProcessor.rmsLevelRight.load());
-    meterC.setLevel(audioProcessor.rmsLevelCenter.load());
-    meterLFE.setLevel(audioProcessor.rmsLevelLFE.load());
-    meterLs.setLevel(audioProcessor.rmsLevelLs.load());
-    meterRs.setLevel(audioProcessor.rmsLevelRs.load());
+    meters.clear();
+
+    for (int ch = 0; ch < meterSnapshot.numChannels; ++ch)
+    {
+        meterRoles[(size_t) ch] = meterSnapshot.channels[(size_t) ch].role;
+        addAndMakeVisible (meters.add (new ProfessionalMeter (OutputLayout::getShortName (meterRoles[(size_t) ch]))));
+    }
+
+    // Die Meter-Spalte wächst mit der Kanalzahl - Hintergrund und Layout neu
+    backgroundImage = {};
+    resized();
+    repaint();
 }
 
 void CoherentUpmixAudioProcessorEditor::loadPreset(int id)
@@ -59,52 +59,129 @@ public:
 class ProfessionalMeter : public juce::Component
 {
 public:
-    ProfessionalMeter(juce::String name) : labelText(name) {}
+    ProfessionalMeter(juce::String name) : labelText(name)
+    {
+        // Malt seine Fläche komplett selbst → der Editor-Hintergrund wird nie mitgezeichnet
+        setOpaque(true);
+    }
 
-    void setLevel(float linearLevel)
+    /** smoothing: Anteil, um den sich die Anzeige in diesem Frame dem Ziel nähert. */
+    void setLevel(float rmsLevel, float peakHoldLevel, float smoothing)
     {
-        float db = juce::Decibels::gainToDecibels(linearLevel, -60.0f);
-        targetLevel = (db + 60.0f) / 66.0f;
-        if (targetLevel < 0.0f) targetLevel = 0.0f;
-        if (targetLevel > 1.0f) targetLevel = 1.0f;
-        currentLevel = 0.7f * currentLevel + 0.3f * targetLevel;
-        repaint();
+        targetLevel = toMeterScale(rmsLevel);
+        currentLevel += smoothing * (targetLevel - currentLevel);
+        holdLevel = toMeterScale(peakHoldLevel);
+
+        // Nur neu zeichnen, wenn sich wirklich ein Pixel ändert
+        const int newBarHeight  = toPixels(currentLevel);
+        const int newHoldHeight = toPixels(holdLevel);
+
+        if (newBarHeight != barHeight || newHoldHeight != holdHeight)
+        {
+            barHeight = newBarHeight;
+            holdHeight = newHoldHeight;
+            repaint(meterArea);
+        }
     }
 
     void paint(juce::Graphics& g) override
     {
-        auto area = getLocalBounds().toFloat();
-        auto labelArea = area.removeFromBottom(15);
-        g.setColour(juce::Colours::grey);
-        g.setFont(10.0f);
-        g.drawText(labelText, labelArea, juce::Justification::centred, false);
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        if (background.isNull() || scale != cachedScale)
+            renderCaches(scale);
+
+        g.drawImage(background, getLocalBounds().toFloat());
+
+        if (barHeight > 0)
+        {
+            // Ausschnitt aus dem vorgerenderten Verlauf - Farbe hängt am Pegel, nicht an der Balkenhöhe
+            const int top = meterArea.getHeight() - barHeight;
+            g.drawImage(gradientStrip,
+                        meterArea.getX(), meterArea.getY() + top, meterArea.getWidth(), barHeight,
+                        0, juce::roundToInt((float) top * cachedScale),
+                        gradientStrip.getWidth(), juce::roundToInt((float) barHeight * cachedScale));
+        }
+
+        if (holdHeight > 0)
+        {
+            g.setColour(juce::Colours::white.withAlpha(0.8f));
+            g.fillRect((float) meterArea.getX(), (float) (meterArea.getBottom() - holdHeight),
+                       (float) meterArea.getWidth(), 1.5f);
+        }
+    }
+
+    void resized() override
+    {
+        auto area = getLocalBounds();
+        area.removeFromBottom(15);
+        meterArea = area.reduced(4, 0);
 
-        auto meterArea = area.reduced(4, 0);
-        g.setColour(juce::Colour::fromString("ff0a0a0a"));
-        g.fillRoundedRectangle(meterArea, 2.0f);
+        background = {};
+        barHeight = toPixels(currentLevel);
+        holdHeight = toPixels(holdLevel);
+    }
+
+private:
+    static float toMeterScale(float linearLevel)
+    {
+        float db = juce::Decibels::gainToDecibels(linearLevel, -60.0f);
+        return juce::jlimit(0.0f, 1.0f, (db + 60.0f) / 66.0f);
+    }
+
+    int toPixels(float level) const { return juce::roundToInt((float) meterArea.getHeight() * level); }
+
+    void renderCaches(float scale)
+    {
+        cachedScale = scale;
 
-        if (currentLevel > 0.001f)
+        const int w = juce::jmax(1, juce::roundToInt((float) getWidth() * scale));
+        const int h = juce::jmax(1, juce::roundToInt((float) getHeight() * scale));
+        background = juce::Image(juce::Image::RGB, w, h, true);
         {
-            float height = meterArea.getHeight() * currentLevel;
-            auto barBounds = meterArea.removeFromBottom(height);
+            juce::Graphics bg(background);
+            bg.addTransform(juce::AffineTransform::scale(scale));
+
+            auto area = getLocalBounds().toFloat();
+            bg.fillAll(juce::Colour::fromString("ff121212"));
+            auto labelArea = area.removeFromBottom(15);
+            bg.setColour(juce::Colours::grey);
+            bg.setFont(10.0f);
+            bg.drawText(labelText, labelArea, juce::Justification::centred, false);
+            bg.setColour(juce::Colour::fromString("ff0a0a0a"));
+            bg.fillRoundedRectangle(meterArea.toFloat(), 2.0f);
+        }
+
+        const int sw = juce::jmax(1, juce::roundToInt((float) meterArea.getWidth() * scale));
+        const int sh = juce::jmax(1, juce::roundToInt((float) meterArea.getHeight() * scale));
+        gradientStrip = juce::Image(juce::Image::RGB, sw, sh, false);
+        {
+            juce::Graphics strip(gradientStrip);
             juce::ColourGradient grad(
-                juce::Colour::fromString("ff005f7f"), barBounds.getBottomLeft(),
-                juce::Colour::fromString("ff00d5ff"), barBounds.getTopLeft(), false);
+                juce::Colour::fromString("ff005f7f"), 0.0f, (float) sh,
+                juce::Colour::fromString("ff00d5ff"), 0.0f, 0.0f, false);
             grad.addColour(0.8, juce::Colour::fromString("ff00ffff"));
             grad.addColour(0.95, juce::Colours::white);
-            g.setGradientFill(grad);
-            g.fillRoundedRectangle(barBounds, 2.0f);
+            strip.setGradientFill(grad);
+            strip.fillAll();
         }
     }
 
-private:
     juce::String labelText;
     float currentLevel = 0.0f;
     float targetLevel = 0.0f;
+    float holdLevel = 0.0f;
+
+    juce::Rectangle<int> meterArea;
+    int barHeight = 0;
+    int holdHeight = 0;
+
+    juce::Image background, gradientStrip;
+    float cachedScale = 0.0f;
 };
 
 //==============================================================================
-class CoherentUpmixAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::Timer
+class CoherentUpmixAudioProcessorEditor  : public juce::AudioProcessorEditor
 {
 public:
     CoherentUpmixAudioProcessorEditor (CoherentUpmixAudioProcessor&);
@@ -112,13 +189,16 @@ public:
 
     void paint (juce::Graphics&) override;
     void resized() override;
-    void timerCallback() override;
 
 private:
     CoherentUpmixAudioProcessor& audioProcessor;
     ModernLookAndFeel modernLook;
 
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& name);
+    void updateMeters();
+    void rebuildMeters();
+    int getMeterPanelWidth() const noexcept { return juce::jmax (180, 60 + 22 * meters.size()); }
+    void renderBackground(float scale);
     void loadPreset(int id);
 
     juce::ComboBox presetSelector;
@@ -150,13 +230,21 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> modeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> loudnessAttachment;
 
-    // Meter werden im Constructor initialisiert
-    ProfessionalMeter meterL;
-    ProfessionalMeter meterR;
-    ProfessionalMeter meterC;
-    ProfessionalMeter meterLFE;
-    ProfessionalMeter meterLs;
-    ProfessionalMeter meterRs;
+    // Ein Meter pro Ausgangskanal, beschriftet nach Rolle (5.1: 6, 7.1: 8, 7.1.4: 12).
+    // Ändert sich das Layout, bringt der nächste Snapshot die neuen Rollen mit.
+    juce::OwnedArray<ProfessionalMeter> meters;
+    std::array<OutputLayout::Role, MeterSnapshot::maxChannels> meterRoles {};
+
+    MeterSnapshot meterSnapshot;
+    double lastMeterUpdateMs = 0.0;
+
+    // Statischer Hintergrund, einmal pro Größe/Skalierung gerendert
+    juce::Image backgroundImage;
+    float backgroundScale = 0.0f;
+
+    // Meter-Updates im Takt der Bildwiederholung (läuft nur, solange das Fenster sichtbar ist).
+    // Als letztes Member: wird zuerst zerstört, danach kommt kein Callback mehr.
+    juce::VBlankAttachment vBlankAttachment { this, [this] { updateMeters(); } };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoherentUpmixAudioProcessorEditor)
 };
@@ -7,22 +7,22 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "UpmixEngine.h"
+#include "UpmixParameters.h"
+
+// Offline-Tools (Tools/) bauen den Prozessor ohne Editor und ohne GUI-Module
+#ifndef COHERENTUPMIX_HEADLESS
+ #define COHERENTUPMIX_HEADLESS 0
+#endif
 
 //==============================================================================
-class CoherentUpmixAudioProcessor  : public juce::AudioProcessor
+class CoherentUpmixAudioProcessor  : public juce::AudioProcessor,
+                                     private juce::AudioProcessorValueTreeState::Listener,
+                                     private juce::AsyncUpdater
 {
 public:
-    // Enum für die Modi (öffentlich)
-    // WICHTIG: Hier muss modeTransient enthalten sein!
-    enum ProcessingMode
-    {
-        modeCoherent = 0,
-        modeNeo6,
-        modeProLogicII,
-        modeTransient, // <-- NEU
-        modeDownmix,
-        modePassThrough  // ← NEU HINZUFÜGEN
-    };
+    // Modi: siehe UpmixEngine
+    using ProcessingMode = UpmixEngine::ProcessingMode;
 
     //==============================================================================
     CoherentUpmixAudioProcessor();
@@ -35,6 +35,9 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    // Host-Bypass mit derselben Latenz wie der Betrieb (sonst verschiebt der Host die Spur)
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -60,47 +63,27 @@ public:
     // Öffentlicher Zugriff für Editor
     juce::AudioProcessorValueTreeState& getValueTreeState() { return apvts; }
     
-    // Metering Values (atomic für Thread-Safety)
-    std::atomic<float> rmsLevelLeft { 0.0f };
-    std::atomic<float> rmsLevelRight { 0.0f };
-    std::atomic<float> rmsLevelCenter { 0.0f };
-    std::atomic<float> rmsLevelLFE { 0.0f };
-    std::atomic<float> rmsLevelLs { 0.0f };
-    std::atomic<float> rmsLevelRs { 0.0f };
+    // Metering: RMS/Peak/Peak-Hold aller Ausgänge als ein Snapshot (lock-free), mit Kanalrollen
+    MeterSnapshotBuffer& getMeterSnapshots() noexcept { return engine.getMeterSnapshots(); }
 
 private:
     //==============================================================================
+    void processBlockWithBypass (juce::AudioBuffer<float>& buffer, bool bypassed);
+
+    // Latenz hängt von Modus und FFT-Größe ab: dem Host vom Message-Thread melden,
+    // nie aus processBlock (setLatencySamples benachrichtigt den Wrapper synchron)
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void updateLatency();
+
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Filter und DSP Objekte (WICHTIG: <float> explizit angeben)
-    juce::dsp::LinkwitzRileyFilter<float> lowPassFilter;
-    juce::dsp::LinkwitzRileyFilter<float> highPassFilter;
-    
-    // Neo:6 Filter
-    juce::dsp::LinkwitzRileyFilter<float> neo6LowPass;
-    juce::dsp::LinkwitzRileyFilter<float> neo6HighPass;
-
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> dialogFilter;
-    juce::dsp::Compressor<float> centerCompressor;
-    juce::dsp::Limiter<float> outputLimiter;
-    juce::dsp::DelayLine<float> surroundDelayLine { 96000 };
-
-    // Helper für Neo:6
-    void processNeo6Band(const float* inL, const float* inR, int numSamples,
-                         float* outL, float* outR, float* outC,
-                         float* outLs, float* outRs,
-                         float surroundGain, float centerWidth,
-                         float& steerState);
-
-    float steerStateLow = 0.0f;
-    float steerStateHigh = 0.0f;
-
-    // WICHTIG: Variablen für Transient Mode hier deklarieren!
-    float fastEnvL = 0.0f;
-    float slowEnvL = 0.0f;
-    float fastEnvR = 0.0f;
-    float slowEnvR = 0.0f;
+    // Muss NACH apvts stehen (wird im Konstruktor daraus aufgelöst)
+    ParameterHandles parameters { apvts };
+
+    // Die gesamte DSP-Kette - ohne APVTS und GUI
+    UpmixEngine engine;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoherentUpmixAudioProcessor)
 };
@@ -0,0 +1,87 @@
+/*
+==============================================================================
+    ScratchArena.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Ein einziger, in prepareToPlay() vorab allozierter Speicherblock für alle
+    Zwischenpuffer von processBlock().
+
+    Jeder Kanal beginnt auf einer 64-Byte-Grenze, damit SIMD-Loads aligned sind.
+    Auf dem Audio-Thread werden nur noch Zeiger herausgegeben - niemals allokiert.
+*/
+class ScratchArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    ScratchArena() = default;
+
+    /** Nur vom Message-Thread (prepareToPlay) aufrufen - allokiert. */
+    void prepare (int numChannelsToAllocate, int maxSamplesPerChannel)
+    {
+        jassert (numChannelsToAllocate > 0 && maxSamplesPerChannel > 0);
+
+        constexpr size_t floatsPerLine = alignment / sizeof (float);
+
+        numChannels = numChannelsToAllocate;
+        maxSamples  = maxSamplesPerChannel;
+        stride      = (((size_t) maxSamples + floatsPerLine - 1) / floatsPerLine) * floatsPerLine;
+
+        storage.allocate (stride * (size_t) numChannels + floatsPerLine, true);
+        channelPointers.allocate ((size_t) numChannels, true);
+
+        auto* base = reinterpret_cast<float*> ((reinterpret_cast<uintptr_t> (storage.get()) + (alignment - 1))
+                                               & ~(uintptr_t) (alignment - 1));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channelPointers[ch] = base + stride * (size_t) ch;
+    }
+
+    void release()
+    {
+        storage.free();
+        channelPointers.free();
+        numChannels = 0;
+        maxSamples  = 0;
+        stride      = 0;
+    }
+
+    int getNumChannels() const noexcept  { return numChannels; }
+    int getMaxSamples() const noexcept   { return maxSamples; }
+
+    float* getChannel (int index) const noexcept
+    {
+        jassert (juce::isPositiveAndBelow (index, numChannels));
+        return channelPointers[index];
+    }
+
+    /** Non-owning Sicht auf einen zusammenhängenden Kanalbereich der Arena. */
+    juce::dsp::AudioBlock<float> getBlock (int firstChannel, int numChannelsInBlock, int numSamples) const noexcept
+    {
+        jassert (firstChannel >= 0 && firstChannel + numChannelsInBlock <= numChannels);
+        jassert (numSamples <= maxSamples);
+        return { channelPointers.get() + firstChannel, (size_t) numChannelsInBlock, (size_t) numSamples };
+    }
+
+    void clear (int firstChannel, int numChannelsToClear, int numSamples) const noexcept
+    {
+        for (int ch = firstChannel; ch < firstChannel + numChannelsToClear; ++ch)
+            juce::FloatVectorOperations::clear (getChannel (ch), numSamples);
+    }
+
+private:
+    juce::HeapBlock<float> storage;
+    juce::HeapBlock<float*> channelPointers;
+    int numChannels = 0;
+    int maxSamples  = 0;
+    size_t stride   = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (ScratchArena)
+};
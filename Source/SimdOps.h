@@ -0,0 +1,254 @@
+/*
+==============================================================================
+    SimdOps.h
+
+    Dünne Hülle um SSE2 / AVX2 / NEON, damit die Kernels in UpmixKernels
+    nur einmal geschrieben werden müssen. Die Auswahl passiert zur
+    Compile-Zeit: AVX2 nur, wenn mit -mavx2 (bzw. /arch:AVX2) gebaut wird,
+    sonst SSE2 auf x86 und NEON auf ARM. Ohne SIMD bleibt ein skalarer
+    Fallback mit Breite 1.
+==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined (__AVX2__)
+ #include <immintrin.h>
+ #define UPMIX_SIMD_AVX2 1
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define UPMIX_SIMD_SSE2 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+ #include <arm_neon.h>
+ #define UPMIX_SIMD_NEON 1
+#else
+ #define UPMIX_SIMD_SCALAR 1
+#endif
+
+#if defined (_MSC_VER)
+ #define UPMIX_RESTRICT __restrict
+ #define UPMIX_INLINE   __forceinline
+#else
+ #define UPMIX_RESTRICT __restrict__
+ #define UPMIX_INLINE   inline __attribute__((always_inline))
+#endif
+
+namespace simd
+{
+
+//==============================================================================
+#if UPMIX_SIMD_AVX2
+
+struct VecF
+{
+    static constexpr int size = 8;
+    static constexpr const char* name = "AVX2";
+    __m256 v;
+};
+
+UPMIX_INLINE VecF load (const float* p) noexcept            { return { _mm256_loadu_ps (p) }; }
+UPMIX_INLINE void store (float* p, VecF a) noexcept         { _mm256_storeu_ps (p, a.v); }
+UPMIX_INLINE VecF broadcast (float x) noexcept              { return { _mm256_set1_ps (x) }; }
+UPMIX_INLINE VecF laneIndex() noexcept                      { return { _mm256_setr_ps (0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f) }; }
+UPMIX_INLINE VecF operator+ (VecF a, VecF b) noexcept       { return { _mm256_add_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF operator- (VecF a, VecF b) noexcept       { return { _mm256_sub_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF operator* (VecF a, VecF b) noexcept       { return { _mm256_mul_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF operator/ (VecF a, VecF b) noexcept       { return { _mm256_div_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF min (VecF a, VecF b) noexcept             { return { _mm256_min_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF max (VecF a, VecF b) noexcept             { return { _mm256_max_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF abs (VecF a) noexcept                     { return { _mm256_andnot_ps (_mm256_set1_ps (-0.0f), a.v) }; }
+UPMIX_INLINE VecF sqrt (VecF a) noexcept                    { return { _mm256_sqrt_ps (a.v) }; }
+
+UPMIX_INLINE float sum (VecF a) noexcept
+{
+    auto x = _mm_add_ps (_mm256_castps256_ps128 (a.v), _mm256_extractf128_ps (a.v, 1));
+    x = _mm_add_ps (x, _mm_movehl_ps (x, x));
+    x = _mm_add_ss (x, _mm_shuffle_ps (x, x, 1));
+    return _mm_cvtss_f32 (x);
+}
+
+//==============================================================================
+#elif UPMIX_SIMD_SSE2
+
+struct VecF
+{
+    static constexpr int size = 4;
+    static constexpr const char* name = "SSE2";
+    __m128 v;
+};
+
+UPMIX_INLINE VecF load (const float* p) noexcept            { return { _mm_loadu_ps (p) }; }
+UPMIX_INLINE void store (float* p, VecF a) noexcept         { _mm_storeu_ps (p, a.v); }
+UPMIX_INLINE VecF broadcast (float x) noexcept              { return { _mm_set1_ps (x) }; }
+UPMIX_INLINE VecF laneIndex() noexcept                      { return { _mm_setr_ps (0.0f, 1.0f, 2.0f, 3.0f) }; }
+UPMIX_INLINE VecF operator+ (VecF a, VecF b) noexcept       { return { _mm_add_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF operator- (VecF a, VecF b) noexcept       { return { _mm_sub_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF operator* (VecF a, VecF b) noexcept       { return { _mm_mul_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF operator/ (VecF a, VecF b) noexcept       { return { _mm_div_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF min (VecF a, VecF b) noexcept             { return { _mm_min_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF max (VecF a, VecF b) noexcept             { return { _mm_max_ps (a.v, b.v) }; }
+UPMIX_INLINE VecF abs (VecF a) noexcept                     { return { _mm_andnot_ps (_mm_set1_ps (-0.0f), a.v) }; }
+UPMIX_INLINE VecF sqrt (VecF a) noexcept                    { return { _mm_sqrt_ps (a.v) }; }
+
+UPMIX_INLINE float sum (VecF a) noexcept
+{
+    auto x = _mm_add_ps (a.v, _mm_movehl_ps (a.v, a.v));
+    x = _mm_add_ss (x, _mm_shuffle_ps (x, x, 1));
+    return _mm_cvtss_f32 (x);
+}
+
+//==============================================================================
+#elif UPMIX_SIMD_NEON
+
+struct VecF
+{
+    static constexpr int size = 4;
+    static constexpr const char* name = "NEON";
+    float32x4_t v;
+};
+
+UPMIX_INLINE VecF load (const float* p) noexcept            { return { vld1q_f32 (p) }; }
+UPMIX_INLINE void store (float* p, VecF a) noexcept         { vst1q_f32 (p, a.v); }
+UPMIX_INLINE VecF broadcast (float x) noexcept              { return { vdupq_n_f32 (x) }; }
+UPMIX_INLINE VecF laneIndex() noexcept                      { alignas (16) static const float idx[4] = { 0.0f, 1.0f, 2.0f, 3.0f }; return { vld1q_f32 (idx) }; }
+UPMIX_INLINE VecF operator+ (VecF a, VecF b) noexcept       { return { vaddq_f32 (a.v, b.v) }; }
+UPMIX_INLINE VecF operator- (VecF a, VecF b) noexcept       { return { vsubq_f32 (a.v, b.v) }; }
+UPMIX_INLINE VecF operator* (VecF a, VecF b) noexcept       { return { vmulq_f32 (a.v, b.v) }; }
+UPMIX_INLINE VecF min (VecF a, VecF b) noexcept             { return { vminq_f32 (a.v, b.v) }; }
+UPMIX_INLINE VecF max (VecF a, VecF b) noexcept             { return { vmaxq_f32 (a.v, b.v) }; }
+UPMIX_INLINE VecF abs (VecF a) noexcept                     { return { vabsq_f32 (a.v) }; }
+
+UPMIX_INLINE float sum (VecF a) noexcept
+{
+   #if defined (__aarch64__) || defined (_M_ARM64)
+    return vaddvq_f32 (a.v);
+   #else
+    auto x = vadd_f32 (vget_low_f32 (a.v), vget_high_f32 (a.v));
+    return vget_lane_f32 (vpadd_f32 (x, x), 0);
+   #endif
+}
+
+UPMIX_INLINE VecF operator/ (VecF a, VecF b) noexcept
+{
+   #if defined (__aarch64__) || defined (_M_ARM64)
+    return { vdivq_f32 (a.v, b.v) };
+   #else
+    // ARMv7: Kehrwert-Schätzung + zwei Newton-Schritte
+    auto r = vrecpeq_f32 (b.v);
+    r = vmulq_f32 (vrecpsq_f32 (b.v, r), r);
+    r = vmulq_f32 (vrecpsq_f32 (b.v, r), r);
+    return { vmulq_f32 (a.v, r) };
+   #endif
+}
+
+UPMIX_INLINE VecF sqrt (VecF a) noexcept
+{
+   #if defined (__aarch64__) || defined (_M_ARM64)
+    return { vsqrtq_f32 (a.v) };
+   #else
+    // ARMv7: x * rsqrt(x) mit zwei Newton-Schritten; 0 bleibt 0
+    const auto x = vmaxq_f32 (a.v, vdupq_n_f32 (1.0e-30f));
+    auto r = vrsqrteq_f32 (x);
+    r = vmulq_f32 (vrsqrtsq_f32 (vmulq_f32 (x, r), r), r);
+    r = vmulq_f32 (vrsqrtsq_f32 (vmulq_f32 (x, r), r), r);
+    return { vmulq_f32 (a.v, r) };
+   #endif
+}
+
+//==============================================================================
+#else
+
+struct VecF
+{
+    static constexpr int size = 1;
+    static constexpr const char* name = "Scalar";
+    float v;
+};
+
+UPMIX_INLINE VecF load (const float* p) noexcept            { return { *p }; }
+UPMIX_INLINE void store (float* p, VecF a) noexcept         { *p = a.v; }
+UPMIX_INLINE VecF broadcast (float x) noexcept              { return { x }; }
+UPMIX_INLINE VecF laneIndex() noexcept                      { return { 0.0f }; }
+UPMIX_INLINE VecF operator+ (VecF a, VecF b) noexcept       { return { a.v + b.v }; }
+UPMIX_INLINE VecF operator- (VecF a, VecF b) noexcept       { return { a.v - b.v }; }
+UPMIX_INLINE VecF operator* (VecF a, VecF b) noexcept       { return { a.v * b.v }; }
+UPMIX_INLINE VecF operator/ (VecF a, VecF b) noexcept       { return { a.v / b.v }; }
+UPMIX_INLINE VecF min (VecF a, VecF b) noexcept             { return { a.v < b.v ? a.v : b.v }; }
+UPMIX_INLINE VecF max (VecF a, VecF b) noexcept             { return { a.v > b.v ? a.v : b.v }; }
+UPMIX_INLINE VecF abs (VecF a) noexcept                     { return { std::abs (a.v) }; }
+UPMIX_INLINE VecF sqrt (VecF a) noexcept                    { return { std::sqrt (a.v) }; }
+UPMIX_INLINE float sum (VecF a) noexcept                    { return a.v; }
+
+#endif
+
+//==============================================================================
+// PairF: zwei unabhängige Lanes (z.B. links/rechts) für rekursive Filter,
+// bei denen nur über die Kanäle, nicht über die Zeit vektorisiert werden kann.
+//==============================================================================
+#if UPMIX_SIMD_AVX2 || UPMIX_SIMD_SSE2
+
+struct PairF    { __m128 v; };
+struct PairMask { __m128 m; };
+
+UPMIX_INLINE PairF makePair (float a, float b) noexcept                  { return { _mm_unpacklo_ps (_mm_set_ss (a), _mm_set_ss (b)) }; }
+UPMIX_INLINE PairF broadcastPair (float x) noexcept                      { return { _mm_set1_ps (x) }; }
+UPMIX_INLINE PairF operator+ (PairF a, PairF b) noexcept                 { return { _mm_add_ps (a.v, b.v) }; }
+UPMIX_INLINE PairF operator- (PairF a, PairF b) noexcept                 { return { _mm_sub_ps (a.v, b.v) }; }
+UPMIX_INLINE PairF operator* (PairF a, PairF b) noexcept                 { return { _mm_mul_ps (a.v, b.v) }; }
+UPMIX_INLINE PairF min (PairF a, PairF b) noexcept                       { return { _mm_min_ps (a.v, b.v) }; }
+UPMIX_INLINE PairF max (PairF a, PairF b) noexcept                       { return { _mm_max_ps (a.v, b.v) }; }
+UPMIX_INLINE PairF abs (PairF a) noexcept                                { return { _mm_andnot_ps (_mm_set1_ps (-0.0f), a.v) }; }
+UPMIX_INLINE PairMask greaterThan (PairF a, PairF b) noexcept            { return { _mm_cmpgt_ps (a.v, b.v) }; }
+UPMIX_INLINE PairF select (PairMask m, PairF a, PairF b) noexcept        { return { _mm_or_ps (_mm_and_ps (m.m, a.v), _mm_andnot_ps (m.m, b.v)) }; }
+UPMIX_INLINE float first (PairF a) noexcept                              { return _mm_cvtss_f32 (a.v); }
+UPMIX_INLINE float second (PairF a) noexcept                             { return _mm_cvtss_f32 (_mm_shuffle_ps (a.v, a.v, 1)); }
+
+#elif UPMIX_SIMD_NEON
+
+struct PairF    { float32x2_t v; };
+struct PairMask { uint32x2_t m; };
+
+UPMIX_INLINE PairF makePair (float a, float b) noexcept                  { return { vset_lane_f32 (b, vdup_n_f32 (a), 1) }; }
+UPMIX_INLINE PairF broadcastPair (float x) noexcept                      { return { vdup_n_f32 (x) }; }
+UPMIX_INLINE PairF operator+ (PairF a, PairF b) noexcept                 { return { vadd_f32 (a.v, b.v) }; }
+UPMIX_INLINE PairF operator- (PairF a, PairF b) noexcept                 { return { vsub_f32 (a.v, b.v) }; }
+UPMIX_INLINE PairF operator* (PairF a, PairF b) noexcept                 { return { vmul_f32 (a.v, b.v) }; }
+UPMIX_INLINE PairF min (PairF a, PairF b) noexcept                       { return { vmin_f32 (a.v, b.v) }; }
+UPMIX_INLINE PairF max (PairF a, PairF b) noexcept                       { return { vmax_f32 (a.v, b.v) }; }
+UPMIX_INLINE PairF abs (PairF a) noexcept                                { return { vabs_f32 (a.v) }; }
+UPMIX_INLINE PairMask greaterThan (PairF a, PairF b) noexcept            { return { vcgt_f32 (a.v, b.v) }; }
+UPMIX_INLINE PairF select (PairMask m, PairF a, PairF b) noexcept        { return { vbsl_f32 (m.m, a.v, b.v) }; }
+UPMIX_INLINE float first (PairF a) noexcept                              { return vget_lane_f32 (a.v, 0); }
+UPMIX_INLINE float second (PairF a) noexcept                             { return vget_lane_f32 (a.v, 1); }
+
+#else
+
+struct PairF    { float a, b; };
+struct PairMask { bool a, b; };
+
+UPMIX_INLINE PairF makePair (float a, float b) noexcept                  { return { a, b }; }
+UPMIX_INLINE PairF broadcastPair (float x) noexcept                      { return { x, x }; }
+UPMIX_INLINE PairF operator+ (PairF x, PairF y) noexcept                 { return { x.a + y.a, x.b + y.b }; }
+UPMIX_INLINE PairF operator- (PairF x, PairF y) noexcept                 { return { x.a - y.a, x.b - y.b }; }
+UPMIX_INLINE PairF operator* (PairF x, PairF y) noexcept                 { return { x.a * y.a, x.b * y.b }; }
+UPMIX_INLINE PairF min (PairF x, PairF y) noexcept                       { return { x.a < y.a ? x.a : y.a, x.b < y.b ? x.b : y.b }; }
+UPMIX_INLINE PairF max (PairF x, PairF y) noexcept                       { return { x.a > y.a ? x.a : y.a, x.b > y.b ? x.b : y.b }; }
+UPMIX_INLINE PairF abs (PairF x) noexcept                                { return { std::abs (x.a), std::abs (x.b) }; }
+UPMIX_INLINE PairMask greaterThan (PairF x, PairF y) noexcept            { return { x.a > y.a, x.b > y.b }; }
+UPMIX_INLINE PairF select (PairMask m, PairF x, PairF y) noexcept        { return { m.a ? x.a : y.a, m.b ? x.b : y.b }; }
+UPMIX_INLINE float first (PairF x) noexcept                              { return x.a; }
+UPMIX_INLINE float second (PairF x) noexcept                             { return x.b; }
+
+#endif
+
+//==============================================================================
+/** Anzahl der Samples, die komplett in SIMD-Schritten abgearbeitet werden können. */
+UPMIX_INLINE int vectorisableLength (int numSamples) noexcept
+{
+    return numSamples - (numSamples % VecF::size);
+}
+
+} // namespace simd
@@ -0,0 +1,219 @@
+/*
+==============================================================================
+    SpectralUpmixer.cpp
+==============================================================================
+*/
+
+#include "SpectralUpmixer.h"
+
+#include <cstring>
+
+//==============================================================================
+void SpectralUpmixer::prepare (double sampleRate)
+{
+    currentSampleRate = sampleRate;
+
+    for (int order = minOrder; order <= maxOrder; ++order)
+        ffts[(size_t) (order - minOrder)] = std::make_unique<juce::dsp::FFT> (order);
+
+    analysisWindow.assign ((size_t) maxSize, 0.0f);
+    synthesisWindow.assign ((size_t) maxSize, 0.0f);
+    timeData.assign ((size_t) maxSize, {});
+    frequencyData.assign ((size_t) maxSize, {});
+
+    input.prepare (2, maxSize);
+    overlap.prepare (numOutputs, maxSize);
+    ready.prepare (numOutputs, maxSize / 2);
+    bins.prepare (numBinChannels, maxSize / 2 + 1);
+
+    // Jede FFT einmal vorwärts und rückwärts rechnen: die Fallback-Implementierung
+    // legt ihre Twiddle-Tabellen beim ersten Aufruf an - das soll nicht im Audio-Thread passieren.
+    for (auto& f : ffts)
+    {
+        f->perform (timeData.data(), frequencyData.data(), false);
+        f->perform (frequencyData.data(), timeData.data(), true);
+    }
+
+    fftSize = 0;
+    configure (getFftSize (1), getHopSize (getFftSize (1), 0));
+}
+
+void SpectralUpmixer::configure (int newFftSize, int newHopSize) noexcept
+{
+    jassert (juce::isPowerOfTwo (newFftSize) && newFftSize <= maxSize && newFftSize % newHopSize == 0);
+
+    if (newFftSize == fftSize && newHopSize == hopSize)
+        return;
+
+    fftSize = newFftSize;
+    hopSize = newHopSize;
+    fft = ffts[(size_t) (juce::roundToInt (std::log2 ((double) fftSize)) - minOrder)].get();
+
+    // sqrt-Hann (periodisch) für Analyse und Synthese; die Summe der Hann-Fenster
+    // über alle Überlappungen ist (fftSize / hopSize) / 2 - so normiert bleibt die Rekonstruktion exakt
+    const float norm = 0.5f * (float) (fftSize / hopSize);
+
+    for (int i = 0; i < fftSize; ++i)
+    {
+        const auto hann = 0.5f - 0.5f * std::cos (juce::MathConstants<float>::twoPi * (float) i / (float) fftSize);
+        analysisWindow[(size_t) i]  = std::sqrt (hann);
+        synthesisWindow[(size_t) i] = std::sqrt (hann) / norm;
+    }
+
+    // Statistik mit ca. 20 ms Zeitkonstante, unabhängig vom Hop
+    smoothing = (float) std::exp (-(double) hopSize / (0.02 * currentSampleRate));
+
+    reset();
+}
+
+void SpectralUpmixer::reset() noexcept
+{
+    input.clear (0, 2, input.getMaxSamples());
+    overlap.clear (0, numOutputs, overlap.getMaxSamples());
+    ready.clear (0, numOutputs, ready.getMaxSamples());
+    bins.clear (binPowerL, 4, bins.getMaxSamples());
+    fill = 0;
+}
+
+//==============================================================================
+void SpectralUpmixer::process (const float* inL, const float* inR,
+                               float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                               int numSamples, const Gains& gains) noexcept
+{
+    float* const outputs[numOutputs] = { outL, outR, outC, outLs, outRs };
+    const int newest = fftSize - hopSize;   // Schreibposition des aktuellen Hops im Eingang
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int n = juce::jmin (numSamples - done, hopSize - fill);
+
+        juce::FloatVectorOperations::copy (input.getChannel (0) + newest + fill, inL + done, n);
+        juce::FloatVectorOperations::copy (input.getChannel (1) + newest + fill, inR + done, n);
+
+        for (int ch = 0; ch < numOutputs; ++ch)
+            juce::FloatVectorOperations::copy (outputs[ch] + done, ready.getChannel (ch) + fill, n);
+
+        fill += n;
+        done += n;
+
+        if (fill == hopSize)
+        {
+            processFrame (gains);
+            fill = 0;
+        }
+    }
+}
+
+//==============================================================================
+namespace
+{
+    /** Ein Bin zweier reeller Ausgänge A und B für die gepackte Rücktransformation. */
+    struct PackedBin
+    {
+        float aRe, aIm, bRe, bIm;
+    };
+}
+
+template <typename SpectrumFunction>
+void SpectralUpmixer::synthesise (SpectrumFunction&& spectrumAt, float* outA, float* outB) noexcept
+{
+    const int n = fftSize, half = fftSize / 2;
+
+    // Y = A + iB; für k > N/2 aus der Hermite-Symmetrie von A und B: conj(A) + i conj(B)
+    for (int k = 0; k <= half; ++k)
+    {
+        const PackedBin s = spectrumAt (k);
+        frequencyData[(size_t) k] = { s.aRe - s.bIm, s.aIm + s.bRe };
+
+        if (k > 0 && k < half)
+            frequencyData[(size_t) (n - k)] = { s.aRe + s.bIm, s.bRe - s.aIm };
+    }
+
+    fft->perform (frequencyData.data(), timeData.data(), true);
+
+    for (int i = 0; i < n; ++i)
+        outA[i] += synthesisWindow[(size_t) i] * timeData[(size_t) i].real();
+
+    if (outB != nullptr)
+        for (int i = 0; i < n; ++i)
+            outB[i] += synthesisWindow[(size_t) i] * timeData[(size_t) i].imag();
+}
+
+void SpectralUpmixer::processFrame (const Gains& gains) noexcept
+{
+    const int n = fftSize, half = fftSize / 2;
+    const float* inL = input.getChannel (0);
+    const float* inR = input.getChannel (1);
+
+    // L und R als Real- und Imaginärteil eines Signals: eine FFT statt zwei
+    for (int i = 0; i < n; ++i)
+        timeData[(size_t) i] = { analysisWindow[(size_t) i] * inL[i], analysisWindow[(size_t) i] * inR[i] };
+
+    fft->perform (timeData.data(), frequencyData.data(), false);
+
+    float* lRe = bins.getChannel (binLRe);
+    float* lIm = bins.getChannel (binLIm);
+    float* rRe = bins.getChannel (binRRe);
+    float* rIm = bins.getChannel (binRIm);
+
+    // Entpacken: L = (Z[k] + conj Z[N-k]) / 2,  R = (Z[k] - conj Z[N-k]) / 2i
+    for (int k = 0; k <= half; ++k)
+    {
+        const auto z  = frequencyData[(size_t) k];
+        const auto zm = frequencyData[(size_t) ((n - k) & (n - 1))];
+
+        lRe[k] = 0.5f * (z.real() + zm.real());
+        lIm[k] = 0.5f * (z.imag() - zm.imag());
+        rRe[k] = 0.5f * (z.imag() + zm.imag());
+        rIm[k] = 0.5f * (zm.real() - z.real());
+    }
+
+    const float surround = juce::jlimit (0.0f, 1.0f, gains.surroundGain);
+
+    UpmixKernels::spectralWeights (lRe, lIm, rRe, rIm,
+                                   bins.getChannel (binPowerL), bins.getChannel (binPowerR),
+                                   bins.getChannel (binCrossRe), bins.getChannel (binCrossIm),
+                                   bins.getChannel (binDirect), bins.getChannel (binCross),
+                                   bins.getChannel (binCenter), bins.getChannel (binAmbience),
+                                   half + 1,
+                                   { smoothing, surround, std::sqrt (1.0f - surround * surround), gains.dialogExtract });
+
+    const float* direct   = bins.getChannel (binDirect);
+    const float* cross    = bins.getChannel (binCross);
+    const float* center   = bins.getChannel (binCenter);
+    const float* ambience = bins.getChannel (binAmbience);
+
+    synthesise ([&] (int k) -> PackedBin
+                {
+                    return { direct[k] * lRe[k] + cross[k] * rRe[k], direct[k] * lIm[k] + cross[k] * rIm[k],
+                             cross[k] * lRe[k] + direct[k] * rRe[k], cross[k] * lIm[k] + direct[k] * rIm[k] };
+                },
+                overlap.getChannel (outFrontL), overlap.getChannel (outFrontR));
+
+    synthesise ([&] (int k) -> PackedBin
+                {
+                    return { ambience[k] * lRe[k], ambience[k] * lIm[k], ambience[k] * rRe[k], ambience[k] * rIm[k] };
+                },
+                overlap.getChannel (outSurroundL), overlap.getChannel (outSurroundR));
+
+    synthesise ([&] (int k) -> PackedBin
+                {
+                    return { center[k] * (lRe[k] + rRe[k]), center[k] * (lIm[k] + rIm[k]), 0.0f, 0.0f };
+                },
+                overlap.getChannel (outCenter), nullptr);
+
+    // Der älteste Hop ist jetzt vollständig: abgeben, Akkumulator und Eingang weiterschieben
+    for (int ch = 0; ch < numOutputs; ++ch)
+    {
+        float* acc = overlap.getChannel (ch);
+        juce::FloatVectorOperations::copy (ready.getChannel (ch), acc, hopSize);
+        std::memmove (acc, acc + hopSize, sizeof (float) * (size_t) (n - hopSize));
+        juce::FloatVectorOperations::clear (acc + n - hopSize, hopSize);
+    }
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        float* data = input.getChannel (ch);
+        std::memmove (data, data + hopSize, sizeof (float) * (size_t) (n - hopSize));
+    }
+}
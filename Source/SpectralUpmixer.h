@@ -0,0 +1,92 @@
+/*
+==============================================================================
+    SpectralUpmixer.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "ScratchArena.h"
+#include "UpmixKernels.h"
+
+//==============================================================================
+/**
+    Upmix im Frequenzbereich: Overlap-Add-STFT (sqrt-Hann, Hop N/2 oder N/4),
+    pro Bin Kohärenz, Panning und Ähnlichkeit, daraus weiche Masken - direkter
+    Schall nach L/C/R, Ambience nach Ls/Rs (UpmixKernels::spectralWeights).
+
+    Pro Frame laufen nur vier komplexe FFTs der Länge N: L und R werden als
+    Real-/Imaginärteil EINES Signals transformiert, die fünf Ausgänge als drei
+    Paare (L'/R', Ls/Rs, C) zurück.
+
+    Die Latenz ist genau fftSize Samples. prepare() allokiert für die größte
+    FFT; configure() wechselt Größe und Hop ohne Allokation.
+*/
+class SpectralUpmixer
+{
+public:
+    static constexpr int minOrder = 9;    // 512
+    static constexpr int maxOrder = 12;   // 4096
+    static constexpr int maxSize  = 1 << maxOrder;
+
+    SpectralUpmixer() = default;
+
+    /** Parameter-Auswahl → FFT-Größe bzw. Hop. */
+    static int getFftSize (int sizeChoice) noexcept                 { return 1 << juce::jlimit (minOrder, maxOrder, minOrder + sizeChoice); }
+    static int getHopSize (int fftSize, int overlapChoice) noexcept { return fftSize / (overlapChoice == 0 ? 2 : 4); }
+
+    struct Gains
+    {
+        float surroundGain  = 0.4f;
+        float dialogExtract = 0.0f;
+    };
+
+    //==============================================================================
+    void prepare (double sampleRate);
+    void configure (int newFftSize, int newHopSize) noexcept;
+    void reset() noexcept;
+
+    int getLatencySamples() const noexcept      { return fftSize; }
+
+    /** Überschreibt die fünf Ausgänge (LFE bleibt unberührt). */
+    void process (const float* inL, const float* inR,
+                  float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                  int numSamples, const Gains& gains) noexcept;
+
+private:
+    void processFrame (const Gains& gains) noexcept;
+
+    /** Gepackte Rücktransformation: A + iB → Realteil nach outA, Imaginärteil nach outB. */
+    template <typename SpectrumFunction>
+    void synthesise (SpectrumFunction&& spectrumAt, float* outA, float* outB) noexcept;
+
+    enum Output { outFrontL, outFrontR, outCenter, outSurroundL, outSurroundR, numOutputs };
+
+    enum Bin
+    {
+        binLRe, binLIm, binRRe, binRIm,
+        binPowerL, binPowerR, binCrossRe, binCrossIm,
+        binDirect, binCross, binCenter, binAmbience,
+        numBinChannels
+    };
+
+    std::array<std::unique_ptr<juce::dsp::FFT>, maxOrder - minOrder + 1> ffts;
+    juce::dsp::FFT* fft = nullptr;
+
+    double currentSampleRate = 44100.0;
+    int fftSize  = 1024;
+    int hopSize  = 512;
+    int fill     = 0;
+    float smoothing = 0.0f;
+
+    std::vector<float> analysisWindow, synthesisWindow;
+    std::vector<juce::dsp::Complex<float>> timeData, frequencyData;
+
+    ScratchArena input;     // 2 Kanäle à maxSize: die letzten fftSize Eingangssamples
+    ScratchArena overlap;   // 5 Kanäle à maxSize: Overlap-Add-Akkumulator
+    ScratchArena ready;     // 5 Kanäle à maxSize / 2: fertiger Hop, wird im nächsten Hop ausgegeben
+    ScratchArena bins;      // Split-Format-Spektren, Statistik und Gewichte
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralUpmixer)
+};
@@ -0,0 +1,221 @@
+/*
+==============================================================================
+    SurroundDelay.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "ScratchArena.h"
+
+//==============================================================================
+/**
+    Mehrkanal-Ringpuffer mit ganzzahliger Verzögerung pro Kanal.
+
+    Größe = maximale Verzögerung + maximale Blockgröße (aus Parameterbereich und
+    Samplerate, nicht pauschal eine Sekunde). Pro Block und Kanal: ein Block
+    hinein und einer heraus, jeweils höchstens zwei memcpy an der Wrap-Grenze.
+
+    Verzögerungsänderungen werden nicht interpoliert, sondern über fadeMs
+    zwischen alter und neuer Leseposition überblendet. Ändert sich das Ziel
+    während einer Blende, folgt die nächste Blende direkt danach.
+
+    Abgriffe (Taps) lesen einen der Ringe ein zweites Mal, mit eigener
+    Verzögerung und eigenem Gain, direkt in einen fremden Ausgangskanal - so
+    entstehen Rear- und Höhenkanäle ohne zusätzliche Kopie des Eingangs.
+
+    48 kHz, 30 ms, 512er Blöcke, Ls/Rs (g++ -O2, x86-64):
+        SurroundDelay            ~16 KB,  ~0.1 ns pro Kanal und Sample
+        DelayLine<Linear>, 1 s  ~384 KB,  ~9.6 ns pro Kanal und Sample
+*/
+class SurroundDelay
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr double fadeMs   = 10.0;
+
+    SurroundDelay() = default;
+
+    /** Allokiert numChannelsToUse Ringe für höchstens maxDelayMs, dazu numTapsToUse Abgriffe. */
+    void prepare (double sampleRate, int maximumBlockSize, int numChannelsToUse, double maxDelayMs, int numTapsToUse = 0)
+    {
+        jassert (numChannelsToUse > 0 && numChannelsToUse + numTapsToUse <= maxChannels);
+
+        currentSampleRate = sampleRate;
+        numChannels  = numChannelsToUse;
+        numTaps      = numTapsToUse;
+        maxChunk     = juce::jmax (1, maximumBlockSize);
+        maxDelay     = (int) std::ceil (maxDelayMs * sampleRate / 1000.0);
+        ringLength   = maxDelay + maxChunk;
+        fadeLength   = juce::jmax (1, juce::roundToInt (fadeMs * sampleRate / 1000.0));
+
+        rings.prepare (numChannels, ringLength);
+        fadeBuffer.prepare (1, maxChunk);
+
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            channels[(size_t) ch].source = juce::jmin (ch, numChannels - 1);
+            channels[(size_t) ch].gain   = 1.0f;
+        }
+
+        reset();
+    }
+
+    /** Abgriff tap liest den Ring von sourceChannel, mit gain multipliziert. */
+    void setTap (int tap, int sourceChannel, float gain) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (tap, numTaps) && juce::isPositiveAndBelow (sourceChannel, numChannels));
+
+        auto& c = channels[(size_t) (numChannels + tap)];
+        c.source = sourceChannel;
+        c.gain   = gain;
+    }
+
+    void reset() noexcept
+    {
+        rings.clear (0, numChannels, ringLength);
+        writePosition = 0;
+
+        for (auto& c : channels)
+        {
+            c.current = c.next = c.target;
+            c.fadeRemaining = 0;
+        }
+    }
+
+    /** Verzögerung in ms; ohne crossfade wird sofort umgeschaltet (z.B. beim ersten Block). */
+    void setDelayMs (int channel, double delayMs, bool crossfade = true) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (channel, numChannels + numTaps));
+
+        auto& c = channels[(size_t) channel];
+        c.target = juce::jlimit (0, maxDelay, juce::roundToInt (delayMs * currentSampleRate / 1000.0));
+
+        if (! crossfade)
+        {
+            c.current = c.next = c.target;
+            c.fadeRemaining = 0;
+        }
+    }
+
+    /** In-place auf den ersten numChannels Kanälen. */
+    void process (const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        process (block, {});
+    }
+
+    /** Dazu die Abgriffe: Kanal t von taps wird mit Abgriff t überschrieben. */
+    void process (const juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& taps) noexcept
+    {
+        const int numSamples = (int) block.getNumSamples();
+        const int tapsInUse  = juce::jmin (numTaps, (int) taps.getNumChannels());
+
+        for (int start = 0; start < numSamples; start += maxChunk)
+        {
+            const auto length = (size_t) juce::jmin (maxChunk, numSamples - start);
+            processChunk (block.getSubBlock ((size_t) start, length),
+                          tapsInUse > 0 ? taps.getSubBlock ((size_t) start, length) : taps, tapsInUse);
+        }
+    }
+
+private:
+    struct Channel
+    {
+        int current = 0, next = 0, target = 0;
+        int fadeRemaining = 0;
+        int source  = 0;      // Ring, aus dem gelesen wird
+        float gain  = 1.0f;
+    };
+
+    void processChunk (const juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& taps, int tapsInUse) noexcept
+    {
+        const int n = (int) block.getNumSamples();
+        const int channelsInUse = juce::jmin (numChannels, (int) block.getNumChannels());
+
+        // Erst alle Ringe schreiben, dann lesen - so funktioniert auch Verzögerung 0
+        for (int ch = 0; ch < channelsInUse; ++ch)
+            copyIntoRing (rings.getChannel (ch), block.getChannelPointer ((size_t) ch), n);
+
+        for (int ch = 0; ch < channelsInUse; ++ch)
+            readChannel (channels[(size_t) ch], block.getChannelPointer ((size_t) ch), n);
+
+        for (int tap = 0; tap < tapsInUse; ++tap)
+            readChannel (channels[(size_t) (numChannels + tap)], taps.getChannelPointer ((size_t) tap), n);
+
+        writePosition = (writePosition + n) % ringLength;
+    }
+
+    void readChannel (Channel& c, float* data, int n) noexcept
+    {
+        const float* ring = rings.getChannel (c.source);
+
+        if (c.fadeRemaining == 0 && c.target != c.current)
+        {
+            c.next = c.target;
+            c.fadeRemaining = fadeLength;
+        }
+
+        copyFromRing (ring, c.current, c.gain, data, n);
+
+        if (c.fadeRemaining > 0)
+        {
+            float* next = fadeBuffer.getChannel (0);
+            copyFromRing (ring, c.next, c.gain, next, n);
+
+            const int m = juce::jmin (n, c.fadeRemaining);
+            const float step = 1.0f / (float) fadeLength;
+            float weight = (float) (fadeLength - c.fadeRemaining + 1) * step;
+
+            for (int i = 0; i < m; ++i, weight += step)
+                data[i] += weight * (next[i] - data[i]);
+
+            juce::FloatVectorOperations::copy (data + m, next + m, n - m);
+
+            c.fadeRemaining -= m;
+
+            if (c.fadeRemaining == 0)
+                c.current = c.next;
+        }
+    }
+
+    void copyIntoRing (float* ring, const float* source, int n) const noexcept
+    {
+        const int first = juce::jmin (n, ringLength - writePosition);
+        juce::FloatVectorOperations::copy (ring + writePosition, source, first);
+        juce::FloatVectorOperations::copy (ring, source + first, n - first);
+    }
+
+    void copyFromRing (const float* ring, int delaySamples, float gain, float* destination, int n) const noexcept
+    {
+        const int start = (writePosition - delaySamples + ringLength) % ringLength;
+        const int first = juce::jmin (n, ringLength - start);
+
+        if (gain == 1.0f)
+        {
+            juce::FloatVectorOperations::copy (destination, ring + start, first);
+            juce::FloatVectorOperations::copy (destination + first, ring, n - first);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copyWithMultiply (destination, ring + start, gain, first);
+            juce::FloatVectorOperations::copyWithMultiply (destination + first, ring, gain, n - first);
+        }
+    }
+
+    std::array<Channel, maxChannels> channels {};   // erst numChannels in-place, dann numTaps Abgriffe
+
+    double currentSampleRate = 44100.0;
+    int numChannels   = 0;
+    int numTaps       = 0;
+    int maxChunk      = 0;
+    int maxDelay      = 0;
+    int ringLength    = 1;
+    int fadeLength    = 1;
+    int writePosition = 0;
+
+    ScratchArena rings;
+    ScratchArena fadeBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SurroundDelay)
+};
@@ -0,0 +1,841 @@
+/*
+==============================================================================
+    UpmixEngine.cpp
+==============================================================================
+*/
+
+#include "UpmixEngine.h"
+#include "AllocationGuard.h"
+
+namespace
+{
+    /** Kanäle jenseits von 5.1 sind Abgriffe aus dem Ls/Rs-Ring des Surround-Delays:
+        später und leiser als die Seiten, damit die Ortung vorn und seitlich bleibt.
+        extraDelayMs kommt zum Surround-Delay-Parameter hinzu (höchstens maxDerivedDelayMs).
+    */
+    struct DerivedChannel
+    {
+        OutputLayout::Role role;
+        int source;             // 0 = Ls, 1 = Rs
+        float extraDelayMs;
+        float gainDb;
+    };
+
+    constexpr DerivedChannel derivedChannelSpecs[] =
+    {
+        { OutputLayout::rearLeft,      0, 10.0f, -3.0f },
+        { OutputLayout::rearRight,     1, 10.0f, -3.0f },
+        { OutputLayout::topFrontLeft,  0,  5.0f, -6.0f },
+        { OutputLayout::topFrontRight, 1,  5.0f, -6.0f },
+        { OutputLayout::topRearLeft,   0, 15.0f, -6.0f },
+        { OutputLayout::topRearRight,  1, 15.0f, -6.0f }
+    };
+}
+
+//==============================================================================
+void UpmixEngine::prepare (double sampleRate, int maximumBlockSize, int numInputChannels, int numOutputChannels)
+{
+    prepare (sampleRate, maximumBlockSize, numInputChannels, OutputLayout::fromNumChannels (numOutputChannels));
+}
+
+void UpmixEngine::prepare (double sampleRate, int maximumBlockSize, int numInputChannels, const OutputLayout& layout)
+{
+    jassert ((numInputChannels == 2 && (layout.numChannels == 2 || layout.isSurround()))
+             || (numInputChannels == 6 && layout.numChannels == 6 && layout.isSurround()));
+
+    currentSampleRate = sampleRate;
+    numInputs  = numInputChannels;
+    numOutputs = layout.numChannels;
+    outputLayout = layout;
+    channelLayout = ! layout.isSurround() ? layoutStereo : (numInputs >= 6 ? layout51To51 : layoutStereoToSurround);
+
+    // Rear- und Höhenkanäle nur, soweit das Layout sie hat - kein Aufwand für fehlende Kanäle
+    const DerivedChannel* derivedSpecs[maxDerivedChannels] {};
+    numDerivedChannels = 0;
+
+    if (channelLayout == layoutStereoToSurround)
+    {
+        for (const auto& spec : derivedChannelSpecs)
+        {
+            if (layout.has (spec.role))
+            {
+                derivedSpecs[numDerivedChannels] = &spec;
+                derivedChannels[(size_t) numDerivedChannels] = layout.getChannelIndex (spec.role);
+                derivedDelayMs[(size_t) numDerivedChannels]  = spec.extraDelayMs;
+                ++numDerivedChannels;
+            }
+        }
+    }
+
+    juce::dsp::ProcessSpec stereoSpec;
+    stereoSpec.sampleRate = sampleRate;
+    stereoSpec.maximumBlockSize = (juce::uint32) maximumBlockSize;
+    stereoSpec.numChannels = 2;
+
+    // Crossover-Koeffizienten setzt updateCoefficients beim ersten Block
+    UpmixKernels::prepareBiquadBank (crossoverBank, 4, 2);
+
+    UpmixKernels::prepareBiquadBank (neo6Bank, 4, 2);
+
+    for (int stage = 0; stage < 2; ++stage)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            UpmixKernels::setBiquadStage (neo6Bank, ch,     stage, UpmixKernels::makeButterworthLowPass  (sampleRate, 3000.0));
+            UpmixKernels::setBiquadStage (neo6Bank, ch + 2, stage, UpmixKernels::makeButterworthHighPass (sampleRate, 3000.0));
+        }
+    }
+
+    UpmixKernels::prepareBiquadBank (dialogBank, 1, 1);
+    UpmixKernels::setBiquadStage (dialogBank, 0, 0, UpmixKernels::makeBandPass (sampleRate, 1500.0, 0.7));
+
+    centerCompressor.prepare (stereoSpec);
+    centerCompressor.reset();
+    centerCompressor.setAttack (5.0f);
+    centerCompressor.setRelease (100.0f);
+    centerCompressor.setRatio (4.0f);
+
+    juce::dsp::ProcessSpec surroundSpec = stereoSpec;
+    surroundSpec.numChannels = 6;
+    outputLimiter.prepare (sampleRate, juce::jmax (1, maximumBlockSize), numOutputs, outputLimiterLookaheadMs, outputLimiterReleaseMs);
+    outputLimiter.setCeilingDecibels (outputCeilingDb);
+
+    surroundDelay.prepare (sampleRate, juce::jmax (1, maximumBlockSize), 2, maxSurroundDelayMs + maxDerivedDelayMs, numDerivedChannels);
+
+    for (int tap = 0; tap < numDerivedChannels; ++tap)
+        surroundDelay.setTap (tap, derivedSpecs[tap]->source, juce::Decibels::decibelsToGain (derivedSpecs[tap]->gainDb));
+
+    // Ls/Rs und alle abgeleiteten Kanäle, jeder mit eigenen Allpass-Längen
+    surroundDecorrelator.prepare (sampleRate, 2 + numDerivedChannels);
+
+    spectral.prepare (sampleRate);
+    spectralBassDelay.prepare (stereoSpec);
+    spectralBassDelay.setMaximumDelayInSamples (SpectralUpmixer::maxSize);
+    spectralPassDelay.prepare (surroundSpec);
+    spectralPassDelay.setMaximumDelayInSamples (SpectralUpmixer::maxSize);
+
+    transientState = {};
+    dialogFilterRunning = false;
+
+    chainIdle = false;
+    resumeFadeLength   = juce::jmax (1, juce::roundToInt (resumeFadeMs * sampleRate / 1000.0));
+    resumeFadePosition = resumeFadeLength;
+
+    surroundContentDetector.prepare (sampleRate);
+    silenceGate.prepare (sampleRate);
+    levelMeter.prepare (sampleRate, outputLayout);
+
+    // Glättung auf den aktuellen Stand setzen, Koeffizienten beim ersten Block neu setzen
+    const auto& params = parameters;
+    surroundBalanceSmoothed.reset (sampleRate, 0.02);
+    dialogExtractSmoothed.reset (sampleRate, 0.02);
+    lfeGainSmoothed.reset (sampleRate, 0.02);
+    boostGainSmoothed.reset (sampleRate, 0.02);
+    decorrelationMixSmoothed.reset (sampleRate, 0.02);
+    surroundBalanceSmoothed.setCurrentAndTargetValue (params.surroundBalance);
+    dialogExtractSmoothed.setCurrentAndTargetValue (params.dialogExtract);
+    lfeGainSmoothed.setCurrentAndTargetValue (juce::Decibels::decibelsToGain (params.lfeAmountDb));
+    boostGainSmoothed.setCurrentAndTargetValue (params.loudnessBoost ? juce::Decibels::decibelsToGain (6.0f) : 1.0f);
+    decorrelationMixSmoothed.setCurrentAndTargetValue (params.surroundDecorrelation ? 1.0f : 0.0f);
+
+    lastCrossoverHz = -1.0f;
+    lastCompAmount  = -1.0f;
+    lastDelayMs     = -1.0f;
+    lastSpectralFftSize = -1;
+    lastSpectralHop     = -1;
+    spectralActive      = false;
+    lastPcaBands        = -1;
+
+    // Alle Zwischenpuffer EINMAL hier allozieren - process allokiert nie
+    scratch.prepare (numScratchChannels, juce::jmax (1, maximumBlockSize));
+}
+
+void UpmixEngine::release()
+{
+    scratch.release();
+}
+
+//==============================================================================
+void UpmixEngine::process (const float* const* input, float* const* output, int numSamples) noexcept
+{
+    // Die Kette arbeitet in-place auf den Ausgängen
+    for (int ch = 0; ch < numInputs; ++ch)
+        if (output[ch] != input[ch])
+            juce::FloatVectorOperations::copy (output[ch], input[ch], numSamples);
+
+    for (int ch = numInputs; ch < numOutputs; ++ch)
+        juce::FloatVectorOperations::clear (output[ch], numSamples);
+
+    process (juce::dsp::AudioBlock<float> (output, (size_t) numOutputs, (size_t) numSamples));
+}
+
+void UpmixEngine::processInChunks (juce::dsp::AudioBlock<float> block, bool bypassed) noexcept
+{
+    juce::ScopedNoDenormals noDenormals;
+    AllocationGuard::ScopedNoAllocation noAllocation;
+
+    const int numSamples = (int) block.getNumSamples();
+    const int maxChunk   = scratch.getMaxSamples();
+
+    if (maxChunk <= 0)
+    {
+        jassertfalse; // prepare wurde nicht aufgerufen
+        return;
+    }
+
+    // Breitere Host-Busse als das vorbereitete Layout: Die Kette schreibt die Kanäle
+    // dahinter nie - leeren statt Host-Daten stehen zu lassen
+    const size_t numChannelsUsed = (size_t) juce::jmax (numInputs, numOutputs);
+
+    if (block.getNumChannels() > numChannelsUsed)
+        block.getSubsetChannelBlock (numChannelsUsed, block.getNumChannels() - numChannelsUsed).clear();
+
+    // Parameter EINMAL pro Block übernehmen - und damit auch die Instanz von processChunk
+    const auto params = parameters;
+    updateCoefficients (params);
+
+    currentRoute = getRoute (params);
+    const auto chunkFunction = bypassed ? &UpmixEngine::processChunkBypassed
+                                        : (useSpecialisedKernels ? getChunkFunction (currentRoute)
+                                                                 : &UpmixEngine::processChunkGeneric);
+
+    // Größere Blöcke als angekündigt werden in Teilblöcken verarbeitet,
+    // damit die Arena nie nachwachsen muss.
+    for (int start = 0; start < numSamples; start += maxChunk)
+        (this->*chunkFunction) (block.getSubBlock ((size_t) start, (size_t) juce::jmin (maxChunk, numSamples - start)), params);
+}
+
+void UpmixEngine::process (juce::dsp::AudioBlock<float> block) noexcept
+{
+    processInChunks (block, false);
+}
+
+void UpmixEngine::processBypassed (juce::dsp::AudioBlock<float> block) noexcept
+{
+    processInChunks (block, true);
+}
+
+int UpmixEngine::getLatencySamples (const Parameters& params) const noexcept
+{
+    if (channelLayout == layoutStereo)
+        return 0;
+
+    const int spectralLatency = params.processingMode == modeSpectral ? SpectralUpmixer::getFftSize (params.spectralFftSize) : 0;
+    return outputLimiter.getLatencySamples() + spectralLatency;
+}
+
+void UpmixEngine::updateCoefficients (const Parameters& params)
+{
+    // Filter/Kompressor/Delay nur anfassen, wenn sich der Parameter wirklich bewegt hat
+    if (params.crossoverHz != lastCrossoverHz)
+    {
+        // Lanes 0/1 = Tiefpass L/R, 2/3 = Hochpass L/R; zwei Butterworth-Stufen = LR4
+        const auto lowPass  = UpmixKernels::makeButterworthLowPass  (currentSampleRate, params.crossoverHz);
+        const auto highPass = UpmixKernels::makeButterworthHighPass (currentSampleRate, params.crossoverHz);
+
+        for (int stage = 0; stage < 2; ++stage)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                UpmixKernels::setBiquadStage (crossoverBank, ch,     stage, lowPass);
+                UpmixKernels::setBiquadStage (crossoverBank, ch + 2, stage, highPass);
+            }
+        }
+
+        lastCrossoverHz = params.crossoverHz;
+    }
+
+    if (params.centerComp != lastCompAmount)
+    {
+        if (params.centerComp > 0.01f)
+        {
+            centerCompressor.setThreshold (-30.0f * params.centerComp);
+            centerCompressor.setRatio (1.0f + (3.0f * params.centerComp));
+        }
+
+        lastCompAmount = params.centerComp;
+    }
+
+    outputLimiter.setTruePeak (params.limiterTruePeak);
+
+    const int pcaBands = params.pcaBands == 0 ? 8 : UpmixKernels::PcaState::maxBands;
+
+    if (pcaBands != lastPcaBands)
+    {
+        UpmixKernels::preparePcaFilterbank (pcaState, currentSampleRate, pcaBands);
+        lastPcaBands = pcaBands;
+    }
+
+    bool tailChanged = false;
+
+    if (params.surroundDelayMs != lastDelayMs)
+    {
+        // Erster Block nach prepare springt direkt, danach wird überblendet
+        for (int ch = 0; ch < 2; ++ch)
+            surroundDelay.setDelayMs (ch, params.surroundDelayMs, lastDelayMs >= 0.0f);
+
+        for (int tap = 0; tap < numDerivedChannels; ++tap)
+            surroundDelay.setDelayMs (2 + tap, params.surroundDelayMs + derivedDelayMs[(size_t) tap], lastDelayMs >= 0.0f);
+
+        lastDelayMs = params.surroundDelayMs;
+        tailChanged = true;
+    }
+
+    // STFT: neue Größe/Hop oder Modus gerade betreten → Puffer leeren und neu einschwingen
+    const int fftSize      = SpectralUpmixer::getFftSize (params.spectralFftSize);
+    const int hopSize      = SpectralUpmixer::getHopSize (fftSize, params.spectralOverlap);
+    const bool spectralNow = params.processingMode == modeSpectral;
+
+    if (fftSize != lastSpectralFftSize || hopSize != lastSpectralHop || spectralNow != spectralActive)
+    {
+        spectral.configure (fftSize, hopSize);
+        spectral.reset();
+
+        // Bass und durchgereichtes 5.1 laufen an der STFT vorbei und werden um ihre Latenz verzögert
+        spectralBassDelay.setDelay ((float) fftSize);
+        spectralBassDelay.reset();
+        spectralPassDelay.setDelay ((float) fftSize);
+        spectralPassDelay.reset();
+
+        lastSpectralFftSize = fftSize;
+        lastSpectralHop     = hopSize;
+        spectralActive      = spectralNow;
+        tailChanged = true;
+    }
+
+    if (tailChanged)
+    {
+        const double latencySeconds = spectralActive ? fftSize / currentSampleRate : 0.0;
+        const double derivedMs = numDerivedChannels > 0 ? maxDerivedDelayMs : 0.0;
+        silenceGate.setTailSeconds ((params.surroundDelayMs + derivedMs + outputLimiterReleaseMs) / 1000.0 + latencySeconds);
+    }
+}
+
+//==============================================================================
+UpmixEngine::Route UpmixEngine::getRoute (const Parameters& params) const noexcept
+{
+    Route route;
+    route.layout = channelLayout;
+    route.mode   = normaliseMode (channelLayout, params.processingMode);
+
+    // Dialog aus heißt: Ziel 0 und die Glättung ist schon dort angekommen
+    route.dialog = usesDialogFilter (route.layout, route.mode)
+                && (params.dialogExtract > 0.0f || dialogExtractSmoothed.getCurrentValue() > 0.0f);
+
+    route.centerComp = usesCenterComp (route.layout, route.mode) && params.centerComp > 0.01f;
+    return route;
+}
+
+template <UpmixEngine::ChannelLayout Layout, int Mode>
+constexpr std::array<UpmixEngine::ChunkFunction, 4> UpmixEngine::makeChunkFunctions() noexcept
+{
+    // Index dialog * 2 + centerComp. Schalter, die der Modus nicht kennt, zeigen auf die
+    // Instanz ohne sie - getRoute liefert sie ohnehin nie, instanziiert wird nur, was läuft.
+    constexpr int  mode   = normaliseMode (Layout, Mode);
+    constexpr bool dialog = usesDialogFilter (Layout, mode);
+    constexpr bool comp   = usesCenterComp (Layout, mode);
+
+    return { &UpmixEngine::processChunkSpecialised<Layout, mode, false,  false>,
+             &UpmixEngine::processChunkSpecialised<Layout, mode, false,  comp>,
+             &UpmixEngine::processChunkSpecialised<Layout, mode, dialog, false>,
+             &UpmixEngine::processChunkSpecialised<Layout, mode, dialog, comp> };
+}
+
+template <UpmixEngine::ChannelLayout Layout, int... Modes>
+constexpr std::array<std::array<UpmixEngine::ChunkFunction, 4>, UpmixEngine::numProcessingModes>
+    UpmixEngine::makeChunkTable (std::integer_sequence<int, Modes...>) noexcept
+{
+    return { makeChunkFunctions<Layout, Modes>()... };
+}
+
+UpmixEngine::ChunkFunction UpmixEngine::getChunkFunction (const Route& route) noexcept
+{
+    // [Layout][Modus][Dialog * 2 + Kompressor] - 34 Instanzen, zur Compile-Zeit gefüllt
+    static constexpr auto modes = std::make_integer_sequence<int, numProcessingModes>();
+    static constexpr std::array<std::array<std::array<ChunkFunction, 4>, numProcessingModes>, numChannelLayouts> table
+    {
+        makeChunkTable<layoutStereo>     (modes),
+        makeChunkTable<layoutStereoToSurround> (modes),
+        makeChunkTable<layout51To51>     (modes)
+    };
+
+    return table[(size_t) route.layout][(size_t) route.mode][(size_t) ((route.dialog ? 2 : 0) + (route.centerComp ? 1 : 0))];
+}
+
+template <UpmixEngine::ChannelLayout Layout, int Mode, bool Dialog, bool CenterComp>
+void UpmixEngine::processChunkSpecialised (juce::dsp::AudioBlock<float> block, const Parameters& params)
+{
+    processChunk (block, params, StaticRoute<Layout, Mode, Dialog, CenterComp>());
+}
+
+void UpmixEngine::processChunkGeneric (juce::dsp::AudioBlock<float> block, const Parameters& params)
+{
+    processChunk (block, params, currentRoute);
+}
+
+void UpmixEngine::processChunkBypassed (juce::dsp::AudioBlock<float> block, const Parameters&)
+{
+    chainIdle = true;
+
+    if (channelLayout != layoutStereo)
+        keepChainWarm (block, currentRoute.mode, currentRoute.dialog);
+
+    if (channelLayout == layoutStereoToSurround)
+        block.getSubsetChannelBlock ((size_t) numInputs, (size_t) (numOutputs - numInputs)).clear();
+
+    // Dieselben Verzögerungen wie im Betrieb: STFT-Latenz über die 5.1-Passthrough-Linie,
+    // danach die Verzögerung des Limiters (ohne Detektor, siehe LookaheadLimiter)
+    if (channelLayout != layoutStereo)
+    {
+        if (spectralActive)
+        {
+            auto passBlock = block.getSubsetChannelBlock (0, 6);
+            juce::dsp::ProcessContextReplacing<float> passCtx (passBlock);
+            spectralPassDelay.process (passCtx);
+        }
+
+        limitAndMeter (block.getSubsetChannelBlock (0, (size_t) numOutputs), false);
+    }
+    else
+    {
+        levelMeter.process (block, meterSnapshots);
+    }
+}
+
+void UpmixEngine::limitAndMeter (const juce::dsp::AudioBlock<float>& output, bool limit) noexcept
+{
+    // Der Limiter schreibt als Letzter - er misst RMS und Spitze im selben Durchlauf
+    if (limit)
+        outputLimiter.process (output, levelMeter.getAccumulators());
+    else
+        outputLimiter.processDelayOnly (output, levelMeter.getAccumulators());
+
+    levelMeter.addMeasuredSamples ((int) output.getNumSamples(), meterSnapshots);
+}
+
+void UpmixEngine::keepChainWarm (const juce::dsp::AudioBlock<float>& block, int mode, bool dialog) noexcept
+{
+    // Nur die Filter, die den Eingang direkt sehen: Band-Splitter (bei Neo:6 samt
+    // 3-kHz-Bändern) und Dialog-Bandpass. Ihre Ausgänge werden verworfen
+    splitBands (block, mode == modeNeo6);
+
+    if (dialog)
+        processDialogFilter (scratch.getBlock (scratchHighPass, 2, (int) block.getNumSamples()));
+
+    dialogFilterRunning = dialog;
+}
+
+void UpmixEngine::resumeChain (const Parameters& params) noexcept
+{
+    // Band-Splitter und Dialog-Bandpass liefen weiter (keepChainWarm), Schätzer (PCA,
+    // Steuerung, Transienten) setzen mit ihrem letzten Stand fort. Surround-Delay,
+    // Dekorrelator und Center-Kompressor sehen nur Upmix-Kanäle, die es im Fast-Path
+    // nicht gab - leer ist ihr passender Zustand
+    centerCompressor.reset();
+    surroundDelay.reset();
+    surroundDecorrelator.reset();
+    chainIdle = false;
+
+    // Der Upmix ist ein anderes Signal als der Fast-Path-Ausgang - ohne Überblendung springt
+    // L/R. Nur die STFT läuft nicht mit (eine FFT pro Hop wäre kein Fast-Path mehr): Sie
+    // liefert erst nach fftSize Samples wieder Ausgang, so lange bleibt es trocken
+    resumeFadePosition = 0;
+
+    if (spectralActive)
+    {
+        spectral.reset();
+        spectralBassDelay.reset();
+        resumeFadePosition = -SpectralUpmixer::getFftSize (params.spectralFftSize);
+    }
+}
+
+void UpmixEngine::applyResumeFade (const juce::dsp::AudioBlock<float>& output, const juce::dsp::AudioBlock<float>& dry) noexcept
+{
+    const int numSamples  = (int) output.getNumSamples();
+    const float step      = 1.0f / (float) resumeFadeLength;
+    const float start     = (float) resumeFadePosition * step;
+
+    for (size_t ch = 0; ch < output.getNumChannels(); ++ch)
+    {
+        float* o = output.getChannelPointer (ch);
+
+        // Kanäle jenseits von 5.1 waren im Fast-Path still
+        if (ch < dry.getNumChannels())
+        {
+            const float* d = dry.getChannelPointer (ch);
+
+            for (int i = 0; i < numSamples; ++i)
+                o[i] = d[i] + juce::jlimit (0.0f, 1.0f, start + (float) (i + 1) * step) * (o[i] - d[i]);
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+                o[i] *= juce::jlimit (0.0f, 1.0f, start + (float) (i + 1) * step);
+        }
+    }
+
+    resumeFadePosition = juce::jmin (resumeFadeLength, resumeFadePosition + numSamples);
+}
+
+void UpmixEngine::splitBands (const juce::dsp::AudioBlock<float>& block, bool neo6) noexcept
+{
+    // Liest den Eingang (L/R) einmal, Ergebnis in den Arena-Slots scratchLowPass/HighPass
+    // bzw. scratchBandLow/High
+    const int numSamples = (int) block.getNumSamples();
+
+    auto lpStereo = scratch.getBlock (scratchLowPass,  2, numSamples);
+    auto hpStereo = scratch.getBlock (scratchHighPass, 2, numSamples);
+    auto subLow   = scratch.getBlock (scratchBandLow,  2, numSamples);
+    auto subHigh  = scratch.getBlock (scratchBandHigh, 2, numSamples);
+
+    const float* inL = block.getChannelPointer (0);
+    const float* inR = block.getChannelPointer (1);
+    const float* inputs[] = { inL, inR, inL, inR };
+
+    if (neo6)
+    {
+        // Der Hochpass existiert nur abschnittsweise auf dem Stack
+        static constexpr int highPassTaps[] = { 2, 3, 2, 3 };
+        float* lowPassOutputs[] = { lpStereo.getChannelPointer (0), lpStereo.getChannelPointer (1), nullptr, nullptr };
+        float* bandOutputs[] = { subLow.getChannelPointer (0),  subLow.getChannelPointer (1),
+                                 subHigh.getChannelPointer (0), subHigh.getChannelPointer (1) };
+        UpmixKernels::biquadBankTree (inputs, lowPassOutputs, crossoverBank,
+                                      highPassTaps, bandOutputs, neo6Bank, numSamples);
+    }
+    else
+    {
+        float* outputs[] = { lpStereo.getChannelPointer (0), lpStereo.getChannelPointer (1),
+                             hpStereo.getChannelPointer (0), hpStereo.getChannelPointer (1) };
+        UpmixKernels::biquadBank (inputs, outputs, numSamples, crossoverBank);
+    }
+}
+
+const float* UpmixEngine::processDialogFilter (const juce::dsp::AudioBlock<float>& highPass) noexcept
+{
+    const int numSamples = (int) highPass.getNumSamples();
+    const float* hpL = highPass.getChannelPointer (0);
+    const float* hpR = highPass.getChannelPointer (1);
+
+    if (! dialogFilterRunning)
+        UpmixKernels::resetBiquadBank (dialogBank);   // kein alter Filterzustand
+
+    auto db = scratch.getBlock (scratchDialog, 1, numSamples);
+
+    auto* dW = db.getChannelPointer (0);
+    for (int i = 0; i < numSamples; ++i)
+        dW[i] = 0.5f * (hpL[i] + hpR[i]);
+
+    const float* dialogIn[] = { dW };
+    UpmixKernels::biquadBank (dialogIn, &dW, numSamples, dialogBank);
+
+    return dW;
+}
+
+/** Schiebt die Glättung um numSamples weiter und liefert die passende Rampe pro Sample. */
+static UpmixKernels::GainRamp advanceSmoothing (juce::SmoothedValue<float>& value, float target, int numSamples) noexcept
+{
+    value.setTargetValue (target);
+
+    if (! value.isSmoothing())
+        return value.getCurrentValue();
+
+    const float start = value.getCurrentValue();
+    const float end   = value.skip (numSamples);
+    const float step  = (end - start) / (float) numSamples;
+
+    return { start + step, step };
+}
+
+// Mit StaticRoute sind alle Abfragen auf route Konstanten: jede Instanz enthält nur
+// ihren eigenen Zweig. Mit Route (generisch) wird zur Laufzeit verzweigt.
+template <typename RouteType>
+void UpmixEngine::processChunk (juce::dsp::AudioBlock<float> block, const Parameters& params, const RouteType& route)
+{
+    const int numSamples = (int) block.getNumSamples();
+
+    // Prüfen, ob auf den 5.1-Surround-Kanälen (C, LFE, Ls, Rs) wirklich Inhalt
+    // liegt. Inkrementell und mit Haltezeit, siehe SurroundContentDetector.
+    const bool hasTrue51Content = route.layout == layout51To51
+                               && surroundContentDetector.process (block, 2, 4);
+
+    // Fall 1: Echter 5.1-Input (Energie auf einem der Kanäle 2..5) → Passthrough
+    if (hasTrue51Content)
+    {
+        keepChainWarm (block, route.mode, route.dialog);
+
+        // Im Spectral-Modus ist Latenz gemeldet - auch das durchgereichte 5.1 muss sie haben
+        if (route.mode == modeSpectral)
+        {
+            auto passBlock = block.getSubsetChannelBlock (0, (size_t) numOutputs);
+            juce::dsp::ProcessContextReplacing<float> passCtx (passBlock);
+            spectralPassDelay.process (passCtx);
+        }
+
+        // Buffer sonst nicht anfassen → echter 5.1-Stream geht unverändert durch,
+        // nur um die Lookahead-Latenz des Limiters verzögert
+        chainIdle = true;
+        limitAndMeter (block.getSubsetChannelBlock (0, (size_t) numOutputs), false);
+        return;
+    }
+    // Pass-Through Modus prüfen
+    if (route.mode == modePassThrough)
+    {
+        // Input steht bereits im Output (In-Place-Buffer) - nichts zu kopieren,
+        // nur die Kanäle ohne Eingang leeren (der Host übergibt dort beliebige Daten)
+        chainIdle = true;
+
+        if (route.layout == layoutStereo)
+        {
+            levelMeter.process (block, meterSnapshots);
+            return;
+        }
+
+        keepChainWarm (block, route.mode, route.dialog);
+
+        if (route.layout == layoutStereoToSurround)
+            block.getSubsetChannelBlock ((size_t) numInputs, (size_t) (numOutputs - numInputs)).clear();
+
+        limitAndMeter (block.getSubsetChannelBlock (0, (size_t) numOutputs), false);
+
+        return;
+    }
+
+    // Ab hier: Upmix-Zweig (Stereo → 5.1/7.1/7.1.4). Für Upmix brauchen wir mindestens 6 Ausgänge.
+    if (route.layout == layoutStereo)
+        return;
+
+    boostGainSmoothed.setTargetValue (params.loudnessBoost ? juce::Decibels::decibelsToGain (6.0f) : 1.0f);
+
+    if (route.mode == modeDownmix)
+    {
+        // L/R tragen den Eingang schon: nur die übrigen Kanäle leeren und den Boost
+        // auf L/R (in jedem Layout Kanal 0 und 1). Ohne Boost wie Pass-Through nur verzögern
+        chainIdle = true;
+        keepChainWarm (block, route.mode, route.dialog);
+        block.getSubsetChannelBlock (2, (size_t) numOutputs - 2).clear();
+
+        auto stereoBlock = block.getSubsetChannelBlock (0, 2);
+        const bool boosted = boostGainSmoothed.isSmoothing() || boostGainSmoothed.getCurrentValue() != 1.0f;
+
+        if (boosted)
+            stereoBlock.multiplyBy (boostGainSmoothed);
+
+        limitAndMeter (block.getSubsetChannelBlock (0, (size_t) numOutputs), boosted);
+        return;
+    }
+
+    // Leerlauf: Eingang länger still als der Tail der Kette → Upmix nicht rechnen.
+    // Erst hier, damit durchgereichtes Material (Fade-Ausklänge, Dither) unverändert bleibt.
+    if (silenceGate.process (block, juce::jmin (numInputs, (int) block.getNumChannels())))
+    {
+        block.clear();
+        levelMeter.processSilence (numSamples, meterSnapshots);
+        return;
+    }
+
+    // Zurück aus einem Fast-Path: Eingang als trockenes Signal für die Einblendung sichern,
+    // im Spectral-Modus um dieselbe Latenz verzögert wie das Ergebnis
+    juce::dsp::AudioBlock<float> resumeDry;
+
+    if (chainIdle)
+        resumeChain (params);
+
+    if (resumeFadePosition < resumeFadeLength)
+    {
+        resumeDry = scratch.getBlock (scratchResumeDry, 6, numSamples);
+        resumeDry.getSubsetChannelBlock (0, (size_t) numInputs).copyFrom (block.getSubsetChannelBlock (0, (size_t) numInputs));
+        resumeDry.getSubsetChannelBlock ((size_t) numInputs, (size_t) (6 - numInputs)).clear();
+
+        if (route.mode == modeSpectral)
+        {
+            juce::dsp::ProcessContextReplacing<float> dryCtx (resumeDry);
+            spectralPassDelay.process (dryCtx);
+        }
+    }
+
+    // Gains als Rampen pro Sample (konstant, solange nichts geglättet wird)
+    const auto surroundBalance = advanceSmoothing (surroundBalanceSmoothed, params.surroundBalance, numSamples);
+    const auto dialogExtract   = advanceSmoothing (dialogExtractSmoothed, params.dialogExtract, numSamples);
+    const auto lfeGain         = advanceSmoothing (lfeGainSmoothed, juce::Decibels::decibelsToGain (params.lfeAmountDb), numSamples);
+
+    // Band-Splitter liest den Eingang einmal und schreibt alle Bänder direkt in die Arena:
+    // Tiefpass (LFE) und Hochpass, bei Neo:6 statt des Hochpasses gleich die 3-kHz-Bänder
+    splitBands (block, route.mode == modeNeo6);
+
+    auto lpStereo = scratch.getBlock (scratchLowPass,  2, numSamples);
+    auto hpStereo = scratch.getBlock (scratchHighPass, 2, numSamples);
+    auto subLow   = scratch.getBlock (scratchBandLow,  2, numSamples);
+    auto subHigh  = scratch.getBlock (scratchBandHigh, 2, numSamples);
+
+    const float* lpL = lpStereo.getChannelPointer (0);
+    const float* lpR = lpStereo.getChannelPointer (1);
+    const float* hpL = hpStereo.getChannelPointer (0);
+    const float* hpR = hpStereo.getChannelPointer (1);
+
+    // Kanalindizes aus dem Layout - bei 7.1.4 liegen die Höhen zwischen Seiten und Rears
+    auto output = [&block, this] (OutputLayout::Role role) { return block.getChannelPointer ((size_t) outputLayout.getChannelIndex (role)); };
+
+    float* outL   = output (OutputLayout::left);
+    float* outR   = output (OutputLayout::right);
+    float* outC   = output (OutputLayout::centre);
+    float* outLFE = output (OutputLayout::lfe);
+    float* outLs  = output (OutputLayout::surroundLeft);
+    float* outRs  = output (OutputLayout::surroundRight);
+
+    float* derived[maxDerivedChannels] {};
+
+    for (int d = 0; d < numDerivedChannels; ++d)
+        derived[d] = block.getChannelPointer ((size_t) derivedChannels[(size_t) d]);
+
+    auto tmpOut = scratch.getBlock (scratchTmpOut, 6, numSamples);
+    tmpOut.clear();
+
+    float* tL   = tmpOut.getChannelPointer (0);
+    float* tR   = tmpOut.getChannelPointer (1);
+    float* tC   = tmpOut.getChannelPointer (2);
+    float* tLFE = tmpOut.getChannelPointer (3);
+    float* tLs  = tmpOut.getChannelPointer (4);
+    float* tRs  = tmpOut.getChannelPointer (5);
+
+    const auto surroundGain = surroundBalance.mapped (0.8f, 0.0f);
+    const auto frontWeight  = surroundBalance.mapped (-1.0f, 1.0f);
+    const auto centerGain   = surroundBalance.mapped (-0.5f, 0.5f);
+    const auto dialogBoost  = dialogExtract.mapped (2.5f, 0.0f);
+    const auto centerWidth  = dialogExtract.mapped (-1.0f, 1.0f);
+
+    if (route.mode == modeNeo6)
+    {
+        const auto steering = getNeo6SteeringInterval (params.neo6Steering);
+
+        processNeo6Band (subLow.getChannelPointer (0), subLow.getChannelPointer (1), numSamples,
+                         tL, tR, tC, tLs, tRs, surroundGain, centerWidth, steering, steerStateLow);
+
+        auto highOut = scratch.getBlock (scratchHighOut, 6, numSamples);
+        highOut.clear();
+        processNeo6Band (subHigh.getChannelPointer (0), subHigh.getChannelPointer (1), numSamples,
+                         highOut.getChannelPointer (0), highOut.getChannelPointer (1),
+                         highOut.getChannelPointer (2), highOut.getChannelPointer (4), highOut.getChannelPointer (5),
+                         surroundGain, centerWidth, steering, steerStateHigh);
+
+        for (int ch : { 0, 1, 2, 4, 5 })
+            juce::FloatVectorOperations::add (tmpOut.getChannelPointer ((size_t) ch),
+                                              highOut.getChannelPointer ((size_t) ch),
+                                              numSamples);
+    }
+    else if (route.mode == modePca)
+    {
+        UpmixKernels::pcaUpmix (hpL, hpR, tL, tR, tC, tLs, tRs, numSamples,
+                                { surroundGain, dialogExtract }, pcaState);
+    }
+    else if (route.mode == modeProLogicII)
+    {
+        UpmixKernels::proLogicMatrix (hpL, hpR, tL, tR, tC, tLs, tRs, numSamples,
+                                      { surroundGain, centerWidth });
+    }
+    else if (route.mode == modeSpectral)
+    {
+        // Gains einmal pro STFT-Frame - der Blockanfang genügt
+        spectral.process (hpL, hpR, tL, tR, tC, tLs, tRs, numSamples,
+                          { surroundGain.start, dialogExtract.start });
+
+        juce::dsp::ProcessContextReplacing<float> bassCtx (lpStereo);
+        spectralBassDelay.process (bassCtx);
+    }
+    else if (route.mode == modeTransient)
+    {
+        UpmixKernels::transientMatrix (hpL, hpR, tL, tR, tC, tLs, tRs, numSamples,
+                                       { centerGain, frontWeight, surroundBalance, dialogExtract },
+                                       transientState);
+    }
+    else
+    {
+        // Dialog-Anhebung aus: kein Bandpass, die Matrix lässt den Dialog-Term weg
+        const float* dR = route.dialog ? processDialogFilter (hpStereo) : nullptr;
+        dialogFilterRunning = route.dialog;
+
+        UpmixKernels::coherentMatrix (hpL, hpR, dR, tL, tR, tC, tLs, tRs, numSamples,
+                                      { centerGain, dialogBoost, surroundBalance, frontWeight });
+    }
+
+    // Rear/Höhen entstehen als Abgriffe des Ls/Rs-Rings direkt in ihren Ausgangskanälen
+    juce::dsp::AudioBlock<float> sideBlock = tmpOut.getSubsetChannelBlock (4, 2);
+    surroundDelay.process (sideBlock, juce::dsp::AudioBlock<float> (derived, (size_t) numDerivedChannels, (size_t) numSamples));
+
+    // Ab hier alle Surround-Kanäle gemeinsam: Ls/Rs aus der Arena, der Rest im Ausgang
+    float* surroundChannels[2 + maxDerivedChannels] { tLs, tRs };
+    std::copy (derived, derived + numDerivedChannels, surroundChannels + 2);
+    const int numSurroundChannels = 2 + numDerivedChannels;
+    juce::dsp::AudioBlock<float> surroundBlock (surroundChannels, (size_t) numSurroundChannels, (size_t) numSamples);
+
+    // Dekorrelation der Surrounds; beim Umschalten wird 20 ms trocken/nass überblendet
+    const float decorrelationTarget = params.surroundDecorrelation ? 1.0f : 0.0f;
+
+    if (decorrelationMixSmoothed.getCurrentValue() == 0.0f && decorrelationTarget > 0.0f)
+        surroundDecorrelator.reset();   // keine alten Ringinhalte einblenden
+
+    const auto decorrelationMix = advanceSmoothing (decorrelationMixSmoothed, decorrelationTarget, numSamples);
+
+    if (decorrelationMix.isRamping())
+    {
+        auto dry = scratch.getBlock (scratchSurroundDry, numSurroundChannels, numSamples);
+        dry.copyFrom (surroundBlock);
+        surroundDecorrelator.process (surroundBlock);
+
+        for (size_t ch = 0; ch < (size_t) numSurroundChannels; ++ch)
+        {
+            const float* d = dry.getChannelPointer (ch);
+            float* w = surroundBlock.getChannelPointer (ch);
+
+            for (int i = 0; i < numSamples; ++i)
+                w[i] = d[i] + decorrelationMix.at (i) * (w[i] - d[i]);
+        }
+    }
+    else if (decorrelationMix.start > 0.0f)
+    {
+        surroundDecorrelator.process (surroundBlock);
+    }
+
+    if (route.centerComp)
+    {
+        juce::dsp::AudioBlock<float> centerBlock = tmpOut.getSubsetChannelBlock (2, 1);
+        juce::dsp::ProcessContextReplacing<float> compCtx (centerBlock);
+        centerCompressor.process (compCtx);
+    }
+
+    UpmixKernels::outputMix (lpL, lpR, tL, tR, tC, tLs, tRs,
+                             outL, outR, outC, outLFE, outLs, outRs,
+                             numSamples, lfeGain);
+
+    auto outBlock = block.getSubsetChannelBlock (0, (size_t) numOutputs);
+
+    if (resumeFadePosition < resumeFadeLength)
+        applyResumeFade (outBlock, resumeDry);
+
+    if (boostGainSmoothed.isSmoothing() || boostGainSmoothed.getCurrentValue() != 1.0f)
+        outBlock.multiplyBy (boostGainSmoothed);
+
+    limitAndMeter (outBlock, true);
+}
+
+//==============================================================================
+UpmixKernels::Neo6SteeringInterval UpmixEngine::getNeo6SteeringInterval (int choiceIndex) noexcept
+{
+    switch (choiceIndex)
+    {
+        case 0:  return UpmixKernels::neo6SteerPerSample;
+        case 1:  return UpmixKernels::neo6SteerEvery16;
+        default: return UpmixKernels::neo6SteerEvery32;
+    }
+}
+
+void UpmixEngine::processNeo6Band (const float* inL, const float* inR, int numSamples,
+                                   float* outL, float* outR, float* outC,
+                                   float* outLs, float* outRs,
+                                   UpmixKernels::GainRamp surroundGain, UpmixKernels::GainRamp centerWidth,
+                                   UpmixKernels::Neo6SteeringInterval steering,
+                                   float& steerState)
+{
+    // Per-Sample-Glätter (Original) liegt in UpmixKernels::reference::neo6Band
+    UpmixKernels::neo6BandControlRate (inL, inR, outL, outR, outC, outLs, outRs, numSamples,
+                                       { surroundGain, centerWidth }, steering, steerState);
+}
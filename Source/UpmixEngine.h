@@ -0,0 +1,332 @@
+/*
+==============================================================================
+    UpmixEngine.h
+
+    Die komplette DSP-Kette ohne AudioProcessor, APVTS und GUI:
+    Crossover, Modus-Kernels, Delay, Kompressor, Limiter und Metering.
+    Ausgang: Stereo, 5.1, 7.1 oder 7.1.4 - beschrieben durch ein OutputLayout.
+
+    Plugin, Benchmarks und Offline-Tools benutzen dieselbe Engine; unter
+    CMake ist sie eine eigene statische Bibliothek (CoherentUpmixEngine),
+    die nur GUI-freie JUCE-Module braucht.
+
+        UpmixEngine engine;
+        engine.prepare (48000.0, 512);          // allokiert
+        engine.setParameters (parameters);      // jederzeit vor process()
+        engine.process (in, out, numSamples);   // Audio-Thread, allokiert nie
+==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "ScratchArena.h"
+#include "UpmixKernels.h"
+#include "ContentDetectors.h"
+#include "LevelMeter.h"
+#include "SpectralUpmixer.h"
+#include "SurroundDecorrelator.h"
+#include "LookaheadLimiter.h"
+#include "SurroundDelay.h"
+#include "OutputLayout.h"
+
+//==============================================================================
+class UpmixEngine
+{
+public:
+    // Enum für die Modi (öffentlich)
+    // WICHTIG: Hier muss modeTransient enthalten sein!
+    enum ProcessingMode
+    {
+        modeCoherent = 0,
+        modeNeo6,
+        modeProLogicII,
+        modeTransient,
+        modeDownmix,
+        modePassThrough,
+        modeSpectral,       // STFT, hat Latenz (siehe getLatencySamples)
+        modePca,            // IIR-Filterbank + PCA pro Band, latenzfrei
+        numProcessingModes
+    };
+
+    /** Alle Parameterwerte für einen Block - einmal zu Beginn von process übernommen. */
+    struct Parameters
+    {
+        float surroundBalance = 0.5f;
+        float lfeAmountDb     = -12.0f;
+        float crossoverHz     = 80.0f;
+        float dialogExtract   = 0.0f;
+        float centerComp      = 0.0f;
+        float surroundDelayMs = 20.0f;
+        int   processingMode  = modeCoherent;
+        bool  loudnessBoost   = false;
+        int   neo6Steering    = 2;
+        int   spectralFftSize = 1;   // Auswahlindex: 512 · 1024 · 2048 · 4096
+        int   spectralOverlap = 0;   // Auswahlindex: Hop N/2 · N/4
+        int   pcaBands        = 0;   // Auswahlindex: 8 · 16 Bänder
+        bool  surroundDecorrelation = true;
+        bool  limiterTruePeak = false;
+    };
+
+    static constexpr float outputLimiterReleaseMs   = 100.0f;
+    static constexpr float outputLimiterLookaheadMs = 1.5f;
+    static constexpr float outputCeilingDb          = -0.3f;
+    static constexpr float maxSurroundDelayMs     = 30.0f;
+    static constexpr float maxDerivedDelayMs      = 15.0f;   // Rear/Höhen zusätzlich zum Surround-Delay
+
+    static constexpr double getTailLengthSeconds() noexcept
+    {
+        return (maxSurroundDelayMs + maxDerivedDelayMs + outputLimiterLookaheadMs + outputLimiterReleaseMs) / 1000.0;
+    }
+
+    //==============================================================================
+    UpmixEngine() = default;
+
+    /** Allokiert alle Zwischenpuffer. Unterstützt: Stereo → Stereo/5.1/7.1/7.1.4 und 5.1 → 5.1.
+        Die Reihenfolge der Ausgänge bestimmt outputLayout (vom Host, siehe OutputLayout::fromChannelSet).
+    */
+    void prepare (double sampleRate, int maximumBlockSize, int numInputChannels, const OutputLayout& outputLayout);
+
+    /** Dasselbe mit JUCE-Reihenfolge: 2, 6, 8 oder 12 Ausgänge (OutputLayout::fromNumChannels). */
+    void prepare (double sampleRate, int maximumBlockSize, int numInputChannels = 2, int numOutputChannels = 6);
+    void release();
+
+    const OutputLayout& getOutputLayout() const noexcept            { return outputLayout; }
+
+    /** Wird beim nächsten process() übernommen; geglättet wird dort. */
+    void setParameters (const Parameters& newParameters) noexcept   { parameters = newParameters; }
+    const Parameters& getParameters() const noexcept                { return parameters; }
+
+    /** Getrennte Ein- und Ausgänge (numInputChannels bzw. numOutputChannels Zeiger).
+        in und out dürfen identisch sein (in-place).
+    */
+    void process (const float* const* input, float* const* output, int numSamples) noexcept;
+
+    /** In-place wie im Plugin: die ersten Kanäle enthalten den Eingang, alle
+        max(in, out) Kanäle werden überschrieben. Beliebig große Blöcke.
+    */
+    void process (juce::dsp::AudioBlock<float> block) noexcept;
+
+    /** Host-Bypass: der Eingang geht um getLatencySamples() verzögert durch, Kanäle ohne
+        Eingang werden geleert. Kein Upmix, nur die Eingangsfilter laufen mit - die Latenz
+        bleibt dieselbe, damit der Host beim Umschalten nicht neu kompensiert.
+    */
+    void processBypassed (juce::dsp::AudioBlock<float> block) noexcept;
+
+    /** Latenz für die zuletzt gesetzten Parameter: Limiter-Lookahead plus fftSize im
+        Spectral-Modus. Ohne 5.1-Ausgang läuft keines von beiden - dann 0.
+    */
+    int getLatencySamples() const noexcept                          { return getLatencySamples (parameters); }
+
+    /** Dasselbe für beliebige Parameter. Liest nur, was prepare setzt - darf also vom
+        Message-Thread aufgerufen werden, während der Audio-Thread process() rechnet.
+    */
+    int getLatencySamples (const Parameters& params) const noexcept;
+
+    /** RMS/Peak/Peak-Hold aller Ausgänge als ein Snapshot (lock-free). */
+    MeterSnapshotBuffer& getMeterSnapshots() noexcept               { return meterSnapshots; }
+
+    /** Nur für Benchmarks: false erzwingt den generischen processChunk, der Modus,
+        Layout und Schalter pro Teilblock zur Laufzeit abfragt. Ergebnis ist bitgleich.
+    */
+    void setSpecialisedKernels (bool shouldUseSpecialisedKernels) noexcept  { useSpecialisedKernels = shouldUseSpecialisedKernels; }
+
+private:
+    //==============================================================================
+    // process und processBypassed: Teilblöcke, damit die Arena nie nachwachsen muss
+    void processInChunks (juce::dsp::AudioBlock<float> block, bool bypassed) noexcept;
+
+    //==============================================================================
+    // Kanal-Layouts aus prepare
+    enum ChannelLayout
+    {
+        layoutStereo = 0,       // 2 → 2
+        layoutStereoToSurround, // 2 → 5.1, 7.1, 7.1.4 (Rear/Höhen als Delay-Abgriffe, ohne eigene Instanz)
+        layout51To51,           // 6 → 6
+        numChannelLayouts
+    };
+
+    /** Der Weg durch processChunk: Layout, Modus und die Schalter, die Schleifen sparen.
+        Normalisiert (siehe getRoute) - was ein Modus nicht benutzt, ist immer false.
+    */
+    struct Route
+    {
+        ChannelLayout layout = layoutStereoToSurround;
+        int  mode       = modeCoherent;
+        bool dialog     = false;   // Dialog-Bandpass im Coherent-Modus
+        bool centerComp = false;   // Center-Kompressor
+    };
+
+    /** Dieselbe Route als Konstanten: jede Kombination wird eine eigene Instanz von
+        processChunk, in der der Optimierer alle Abfragen darauf entfernt.
+    */
+    template <ChannelLayout Layout, int Mode, bool Dialog, bool CenterComp>
+    struct StaticRoute
+    {
+        static constexpr ChannelLayout layout = Layout;
+        static constexpr int  mode       = Mode;
+        static constexpr bool dialog     = Dialog;
+        static constexpr bool centerComp = CenterComp;
+    };
+
+    using ChunkFunction = void (UpmixEngine::*) (juce::dsp::AudioBlock<float>, const Parameters&);
+
+    // Regeln der Normalisierung - zur Laufzeit (getRoute) und beim Aufbau der Tabelle dieselben
+    static constexpr int normaliseMode (ChannelLayout layout, int mode) noexcept
+    {
+        // 2 → 2 kennt nur Durchreichen oder nichts tun; unbekannte Modi laufen als Coherent
+        if (layout == layoutStereo)
+            return mode == modePassThrough ? modePassThrough : modeCoherent;
+
+        return mode >= 0 && mode < numProcessingModes ? mode : modeCoherent;
+    }
+
+    static constexpr bool usesDialogFilter (ChannelLayout layout, int mode) noexcept
+    {
+        return layout != layoutStereo && mode == modeCoherent;
+    }
+
+    static constexpr bool usesCenterComp (ChannelLayout layout, int mode) noexcept
+    {
+        return layout != layoutStereo && mode != modeDownmix && mode != modePassThrough;
+    }
+
+    Route getRoute (const Parameters& params) const noexcept;
+    static ChunkFunction getChunkFunction (const Route& route) noexcept;
+
+    template <ChannelLayout Layout, int Mode>
+    static constexpr std::array<ChunkFunction, 4> makeChunkFunctions() noexcept;
+
+    template <ChannelLayout Layout, int... Modes>
+    static constexpr std::array<std::array<ChunkFunction, 4>, numProcessingModes> makeChunkTable (std::integer_sequence<int, Modes...>) noexcept;
+
+    // Verarbeitet höchstens scratch.getMaxSamples() Samples am Stück
+    template <typename RouteType>
+    void processChunk (juce::dsp::AudioBlock<float> block, const Parameters& params, const RouteType& route);
+
+    template <ChannelLayout Layout, int Mode, bool Dialog, bool CenterComp>
+    void processChunkSpecialised (juce::dsp::AudioBlock<float> block, const Parameters& params);
+
+    // Generischer Pfad: fragt currentRoute zur Laufzeit ab
+    void processChunkGeneric (juce::dsp::AudioBlock<float> block, const Parameters& params);
+
+    // Host-Bypass: nur Laufzeitausgleich (Limiter-Lookahead, ggf. STFT)
+    void processChunkBypassed (juce::dsp::AudioBlock<float> block, const Parameters& params);
+
+    // Downmix, Pass-Through, Bypass und echtes 5.1 speisen die Eingangsfilter weiter;
+    // resumeChain im ersten Upmix-Teilblock danach
+    void keepChainWarm (const juce::dsp::AudioBlock<float>& block, int mode, bool dialog) noexcept;
+    void resumeChain (const Parameters& params) noexcept;
+    void applyResumeFade (const juce::dsp::AudioBlock<float>& output, const juce::dsp::AudioBlock<float>& dry) noexcept;
+
+    // Band-Splitter und Dialog-Bandpass, Ausgänge in der Arena
+    void splitBands (const juce::dsp::AudioBlock<float>& block, bool neo6) noexcept;
+    const float* processDialogFilter (const juce::dsp::AudioBlock<float>& highPass) noexcept;
+
+    // Letzte Stufe jedes Pfads mit 5.1-Ausgang: Limiter (limit = false: nur seine Verzögerung) plus Meter
+    void limitAndMeter (const juce::dsp::AudioBlock<float>& output, bool limit) noexcept;
+
+    void updateCoefficients (const Parameters& params);
+
+    // Helper für Neo:6
+    void processNeo6Band (const float* inL, const float* inR, int numSamples,
+                          float* outL, float* outR, float* outC,
+                          float* outLs, float* outRs,
+                          UpmixKernels::GainRamp surroundGain, UpmixKernels::GainRamp centerWidth,
+                          UpmixKernels::Neo6SteeringInterval steering,
+                          float& steerState);
+
+    static UpmixKernels::Neo6SteeringInterval getNeo6SteeringInterval (int choiceIndex) noexcept;
+
+    //==============================================================================
+    Parameters parameters;
+
+    double currentSampleRate = 44100.0;
+    int numInputs  = 2;
+    int numOutputs = 6;
+    ChannelLayout channelLayout = layoutStereoToSurround;
+    OutputLayout outputLayout;
+
+    // Ausgänge jenseits von 5.1 (Rear, Höhen): Kanalindex pro Abgriff des Surround-Delays
+    static constexpr int maxDerivedChannels = OutputLayout::maxChannels - 6;
+    std::array<int, maxDerivedChannels> derivedChannels {};
+    std::array<float, maxDerivedChannels> derivedDelayMs {};
+    int numDerivedChannels = 0;
+
+    Route currentRoute;
+    bool useSpecialisedKernels = true;
+    bool dialogFilterRunning   = false;   // Bandpass-Zustand beim Wiedereinschalten leeren
+
+    // Downmix, Pass-Through und Bypass rechnen die Kette nicht, nur ihre Eingangsfilter.
+    // Beim Zurückschalten wird der Upmix über resumeFadeMs vom Eingang her eingeblendet -
+    // im Spectral-Modus erst, wenn die geleerte STFT wieder Ausgang liefert.
+    static constexpr double resumeFadeMs = 20.0;
+    bool chainIdle = false;
+    int resumeFadeLength   = 1;
+    int resumeFadePosition = 1;   // < resumeFadeLength: Einblendung läuft, < 0: Vorlauf
+
+    // Geglättete Gains (pro Sample, ca. 20 ms) gegen Zipper-Noise bei Automation
+    juce::SmoothedValue<float> surroundBalanceSmoothed;
+    juce::SmoothedValue<float> dialogExtractSmoothed;
+    juce::SmoothedValue<float> lfeGainSmoothed;
+    juce::SmoothedValue<float> boostGainSmoothed;
+    juce::SmoothedValue<float> decorrelationMixSmoothed;   // 0 = trocken, 1 = dekorreliert
+
+    // Zuletzt gesetzte Koeffizienten - neu berechnet wird nur bei Änderung
+    float lastCrossoverHz   = -1.0f;
+    float lastCompAmount    = -1.0f;
+    float lastDelayMs       = -1.0f;
+    int lastSpectralFftSize = -1;
+    int lastSpectralHop     = -1;
+    bool spectralActive     = false;
+    int lastPcaBands        = -1;
+
+    // Alle Filter als SIMD-Biquad-Bänke (Lanes = Kanal x Filter):
+    // Crossover LP L/R + HP L/R, Neo:6-Split bei 3 kHz auf dem HP-Signal, Dialog-Bandpass.
+    // Crossover und Neo:6-Split laufen bei Neo:6 als ein Band-Splitter-Baum (biquadBankTree).
+    UpmixKernels::BiquadBank crossoverBank;
+    UpmixKernels::BiquadBank neo6Bank;
+    UpmixKernels::BiquadBank dialogBank;
+    juce::dsp::Compressor<float> centerCompressor;
+    LookaheadLimiter outputLimiter;
+    SurroundDelay surroundDelay;
+    SurroundDecorrelator surroundDecorrelator;
+
+    // Spectral-Modus: STFT-Upmix plus Laufzeitausgleich für alles, was an ihm vorbeiläuft
+    SpectralUpmixer spectral;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> spectralBassDelay;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> spectralPassDelay;
+
+    SurroundContentDetector surroundContentDetector;
+    SilenceIdleGate silenceGate;
+    LevelMeterAccumulator levelMeter;
+    MeterSnapshotBuffer meterSnapshots;
+
+    // Vorab allozierte Zwischenpuffer (siehe prepare)
+    enum ScratchChannel
+    {
+        scratchLowPass  = 0,  // 2 Kanäle
+        scratchHighPass = 2,  // 2 Kanäle
+        scratchTmpOut   = 4,  // 6 Kanäle
+        scratchBandLow  = 10, // 2 Kanäle
+        scratchBandHigh = 12, // 2 Kanäle
+        scratchHighOut  = 14, // 6 Kanäle
+        scratchDialog   = 20, // 1 Kanal
+        scratchSurroundDry = 21, // bis 8 Kanäle: Ls/Rs + abgeleitete (Überblendung der Dekorrelation)
+        scratchResumeDry   = scratchSurroundDry + 2 + maxDerivedChannels, // 6 Kanäle: Eingang (resumeChain)
+        numScratchChannels = scratchResumeDry + 6
+    };
+
+    ScratchArena scratch;
+
+    float steerStateLow = 0.0f;
+    float steerStateHigh = 0.0f;
+
+    // Hüllkurven für Transient Mode (schnell/langsam, L/R)
+    UpmixKernels::TransientState transientState;
+
+    // Filterbank, Kovarianzen und Matrix des PCA-Modus (eine SIMD-Lane pro Band)
+    UpmixKernels::PcaState pcaState;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UpmixEngine)
+};
@@ -0,0 +1,1567 @@
+/*
+==============================================================================
+    UpmixKernels.cpp
+==============================================================================
+*/
+
+#include "UpmixKernels.h"
+#include "SimdOps.h"
+
+#include <algorithm>
+
+using namespace simd;
+
+const char* UpmixKernels::getInstructionSetName() noexcept { return VecF::name; }
+
+//==============================================================================
+// Skalare Referenz (1:1 die alten Schleifen aus processBlock, Gains per at(n))
+//==============================================================================
+void UpmixKernels::reference::coherentMatrix (const float* hpL, const float* hpR, const float* dR,
+                                              float* tL, float* tR, float* tC, float* tLs, float* tRs,
+                                              int numSamples, const CoherentGains& g) noexcept
+{
+    for (int n = 0; n < numSamples; ++n)
+    {
+        float l = hpL[n];
+        float r = hpR[n];
+        float monoMid = 0.5f * (l + r);
+
+        tC[n]  = dR != nullptr ? (g.centerGain.at (n) * monoMid) + (dR[n] * g.dialogBoost.at (n))
+                               : g.centerGain.at (n) * monoMid;
+        tLs[n] = l * g.surroundBalance.at (n);
+        tRs[n] = r * g.surroundBalance.at (n);
+        tL[n]  = l * g.frontWeight.at (n);
+        tR[n]  = r * g.frontWeight.at (n);
+    }
+}
+
+void UpmixKernels::reference::proLogicMatrix (const float* hpL, const float* hpR,
+                                              float* tL, float* tR, float* tC, float* tLs, float* tRs,
+                                              int numSamples, const ProLogicGains& g) noexcept
+{
+    const float matrixSurroundBoost = 1.6f;
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        float l   = hpL[n];
+        float r   = hpR[n];
+        float sum = (l + r) * 0.707f;
+        float diff = (l - r) * 0.707f;
+
+        tC[n] = sum;
+
+        float surrL = (diff * 0.7f) + (l * 0.3f);
+        float surrR = (-diff * 0.7f) + (r * 0.3f);
+        tLs[n] = surrL * g.surroundGain.at (n) * matrixSurroundBoost;
+        tRs[n] = surrR * g.surroundGain.at (n) * matrixSurroundBoost;
+
+        float subtractionFactor = (1.0f - g.centerWidth.at (n)) * 0.8f;
+        tL[n] = l - (sum * subtractionFactor);
+        tR[n] = r - (sum * subtractionFactor);
+    }
+}
+
+void UpmixKernels::reference::outputMix (const float* lpL, const float* lpR,
+                                         const float* tL, const float* tR, const float* tC, const float* tLs, const float* tRs,
+                                         float* outL, float* outR, float* outC, float* outLFE, float* outLs, float* outRs,
+                                         int numSamples, GainRamp lfeGain) noexcept
+{
+    for (int n = 0; n < numSamples; ++n)
+    {
+        float monoBass = 0.5f * (lpL[n] + lpR[n]);
+        outLFE[n] = monoBass * lfeGain.at (n);
+        outL[n]   = tL[n] + lpL[n];
+        outR[n]   = tR[n] + lpR[n];
+        outC[n]   = tC[n];
+        outLs[n]  = tLs[n];
+        outRs[n]  = tRs[n];
+    }
+}
+
+void UpmixKernels::reference::neo6Band (const float* inL, const float* inR,
+                                        float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                                        int numSamples, const Neo6Gains& g, float& steerState) noexcept
+{
+    const float alpha = 0.9995f;
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const float surroundGain = g.surroundGain.at (n);
+        const float centerWidth  = g.centerWidth.at (n);
+
+        float l = inL[n];
+        float r = inR[n];
+        float sum = (l + r) * 0.707f;
+        float diff = (l - r) * 0.707f;
+        float absSum = std::abs(sum);
+        float absDiff = std::abs(diff) + 0.0001f;
+        float targetSteer = (absSum - absDiff) / (absSum + absDiff);
+
+        steerState = (steerState * alpha) + (targetSteer * (1.0f - alpha));
+        float smoothSteer = steerState;
+
+        float cGain = 0.0f; float sGain = 0.0f; float lrGain = 1.0f;
+        if (smoothSteer > 0.0f) { cGain = smoothSteer; lrGain = 1.0f - smoothSteer; sGain = 0.0f; }
+        else { sGain = -smoothSteer; lrGain = 1.0f - sGain; cGain = 0.0f; }
+
+        if (centerWidth > 0.0f && cGain > 0.0f) {
+            float bleed = cGain * centerWidth;
+            cGain -= bleed;
+            lrGain += bleed;
+        }
+
+        outC[n] += sum * cGain;
+        outLs[n] += diff * sGain * surroundGain;
+        outRs[n] += -diff * sGain * surroundGain;
+        outL[n] += l * lrGain;
+        outR[n] += r * lrGain;
+    }
+}
+
+void UpmixKernels::reference::transientMatrix (const float* hpL, const float* hpR,
+                                               float* tL, float* tR, float* tC, float* tLs, float* tRs,
+                                               int numSamples, const TransientGains& g, TransientState& st) noexcept
+{
+    const float att = 0.9f;
+    const float rel = 0.999f;
+
+    float fastEnvL = st.fastEnvL, slowEnvL = st.slowEnvL;
+    float fastEnvR = st.fastEnvR, slowEnvR = st.slowEnvR;
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const float centerGain      = g.centerGain.at (n);
+        const float frontWeight     = g.frontWeight.at (n);
+        const float surroundBalance = g.surroundBalance.at (n);
+        const float dialogExtract   = g.dialogExtract.at (n);
+
+        float l = hpL[n];
+        float r = hpR[n];
+
+        float absL = std::abs (l);
+        float absR = std::abs (r);
+
+        if (absL > fastEnvL) fastEnvL = absL; else fastEnvL *= att;
+        if (absL > slowEnvL) slowEnvL = absL; else slowEnvL = (slowEnvL * rel) + (absL * (1.0f - rel));
+        if (absR > fastEnvR) fastEnvR = absR; else fastEnvR *= att;
+        if (absR > slowEnvR) slowEnvR = absR; else slowEnvR = (slowEnvR * rel) + (absR * (1.0f - rel));
+
+        float ratioL = (fastEnvL - slowEnvL); if (ratioL < 0.0f) ratioL = 0.0f;
+        ratioL *= 4.0f; if (ratioL > 1.0f) ratioL = 1.0f;
+
+        float ratioR = (fastEnvR - slowEnvR); if (ratioR < 0.0f) ratioR = 0.0f;
+        ratioR *= 4.0f; if (ratioR > 1.0f) ratioR = 1.0f;
+
+        float transWeightL = ratioL; float susWeightL = 1.0f - ratioL;
+        float transWeightR = ratioR; float susWeightR = 1.0f - ratioR;
+
+        float monoSum = (l + r) * 0.5f;
+
+        tC[n] = monoSum * ((susWeightL + susWeightR) * 0.5f) * centerGain;
+        if (dialogExtract > 0.0f)
+            tC[n] += monoSum * dialogExtract;
+
+        tL[n]  = l * (transWeightL + (susWeightL * frontWeight));
+        tR[n]  = r * (transWeightR + (susWeightR * frontWeight));
+        tLs[n] = l * susWeightL * surroundBalance * 1.5f;
+        tRs[n] = r * susWeightR * surroundBalance * 1.5f;
+    }
+
+    st.fastEnvL = fastEnvL; st.slowEnvL = slowEnvL;
+    st.fastEnvR = fastEnvR; st.slowEnvR = slowEnvR;
+}
+
+//==============================================================================
+// SIMD-Varianten. Die restrict-Zeiger sagen dem Compiler, dass sich die
+// sechs Streams nicht überlappen; die Rest-Samples laufen über die Referenz.
+// Jeder Kernel existiert zweimal: mit konstanten Gains (Normalfall) und mit
+// Rampen, solange ein Parameter geglättet wird.
+//==============================================================================
+namespace
+{
+    template <bool Ramped>
+    struct VecGain
+    {
+        explicit VecGain (const UpmixKernels::GainRamp& g) noexcept
+            : start (broadcast (g.start)), step (broadcast (g.step)) {}
+
+        UPMIX_INLINE VecF at (int n) const noexcept
+        {
+            if constexpr (Ramped)
+                return start + (broadcast ((float) n) + laneIndex()) * step;
+            else
+                return start;
+        }
+
+        VecF start, step;
+    };
+
+    template <bool withDialog, bool Ramped>
+    void coherentImpl (const float* UPMIX_RESTRICT hpL, const float* UPMIX_RESTRICT hpR,
+                       const float* UPMIX_RESTRICT dR,
+                       float* UPMIX_RESTRICT tL, float* UPMIX_RESTRICT tR, float* UPMIX_RESTRICT tC,
+                       float* UPMIX_RESTRICT tLs, float* UPMIX_RESTRICT tRs,
+                       int vecEnd, const UpmixKernels::CoherentGains& g) noexcept
+    {
+        const auto half = broadcast (0.5f);
+        const VecGain<Ramped> centerGain (g.centerGain), dialogBoost (g.dialogBoost),
+                              surround (g.surroundBalance), front (g.frontWeight);
+
+        for (int n = 0; n < vecEnd; n += VecF::size)
+        {
+            const auto l = load (hpL + n);
+            const auto r = load (hpR + n);
+            const auto monoMid = half * (l + r);
+            const auto s = surround.at (n);
+            const auto f = front.at (n);
+
+            if constexpr (withDialog)
+                store (tC + n, (centerGain.at (n) * monoMid) + (load (dR + n) * dialogBoost.at (n)));
+            else
+                store (tC + n, centerGain.at (n) * monoMid);
+
+            store (tLs + n, l * s);
+            store (tRs + n, r * s);
+            store (tL  + n, l * f);
+            store (tR  + n, r * f);
+        }
+    }
+
+    template <bool Ramped>
+    void proLogicImpl (const float* UPMIX_RESTRICT hpL, const float* UPMIX_RESTRICT hpR,
+                       float* UPMIX_RESTRICT tL, float* UPMIX_RESTRICT tR, float* UPMIX_RESTRICT tC,
+                       float* UPMIX_RESTRICT tLs, float* UPMIX_RESTRICT tRs,
+                       int vecEnd, const UpmixKernels::ProLogicGains& g) noexcept
+    {
+        const auto k0707 = broadcast (0.707f);
+        const auto k07   = broadcast (0.7f);
+        const auto k03   = broadcast (0.3f);
+        const auto boost = broadcast (1.6f);
+        const VecGain<Ramped> surround (g.surroundGain);
+        const VecGain<Ramped> subtraction ({ (1.0f - g.centerWidth.start) * 0.8f, -0.8f * g.centerWidth.step });
+
+        for (int n = 0; n < vecEnd; n += VecF::size)
+        {
+            const auto l    = load (hpL + n);
+            const auto r    = load (hpR + n);
+            const auto sum  = (l + r) * k0707;
+            const auto diff = (l - r) * k0707;
+            const auto diffScaled = diff * k07;
+            const auto s = surround.at (n);
+
+            store (tC + n, sum);
+            store (tLs + n, ((diffScaled + (l * k03)) * s) * boost);
+            store (tRs + n, (((r * k03) - diffScaled) * s) * boost);
+
+            const auto centerCut = sum * subtraction.at (n);
+            store (tL + n, l - centerCut);
+            store (tR + n, r - centerCut);
+        }
+    }
+
+    template <bool Ramped>
+    void outputMixImpl (const float* UPMIX_RESTRICT lpL, const float* UPMIX_RESTRICT lpR,
+                        const float* UPMIX_RESTRICT tL, const float* UPMIX_RESTRICT tR,
+                        const float* UPMIX_RESTRICT tC, const float* UPMIX_RESTRICT tLs,
+                        const float* UPMIX_RESTRICT tRs,
+                        float* UPMIX_RESTRICT outL, float* UPMIX_RESTRICT outR, float* UPMIX_RESTRICT outC,
+                        float* UPMIX_RESTRICT outLFE, float* UPMIX_RESTRICT outLs, float* UPMIX_RESTRICT outRs,
+                        int vecEnd, UpmixKernels::GainRamp lfeGain) noexcept
+    {
+        const auto half = broadcast (0.5f);
+        const VecGain<Ramped> lfe (lfeGain);
+
+        for (int n = 0; n < vecEnd; n += VecF::size)
+        {
+            const auto bassL = load (lpL + n);
+            const auto bassR = load (lpR + n);
+
+            store (outLFE + n, (half * (bassL + bassR)) * lfe.at (n));
+            store (outL   + n, load (tL + n) + bassL);
+            store (outR   + n, load (tR + n) + bassR);
+            store (outC   + n, load (tC + n));
+            store (outLs  + n, load (tLs + n));
+            store (outRs  + n, load (tRs + n));
+        }
+    }
+}
+
+void UpmixKernels::coherentMatrix (const float* hpL, const float* hpR, const float* dR,
+                                   float* tL, float* tR, float* tC, float* tLs, float* tRs,
+                                   int numSamples, const CoherentGains& g) noexcept
+{
+    const int vecEnd = vectorisableLength (numSamples);
+
+    const bool ramped = g.centerGain.isRamping() || g.dialogBoost.isRamping()
+                     || g.surroundBalance.isRamping() || g.frontWeight.isRamping();
+
+    if (dR != nullptr)
+    {
+        if (ramped) coherentImpl<true, true>   (hpL, hpR, dR, tL, tR, tC, tLs, tRs, vecEnd, g);
+        else        coherentImpl<true, false>  (hpL, hpR, dR, tL, tR, tC, tLs, tRs, vecEnd, g);
+    }
+    else
+    {
+        if (ramped) coherentImpl<false, true>  (hpL, hpR, dR, tL, tR, tC, tLs, tRs, vecEnd, g);
+        else        coherentImpl<false, false> (hpL, hpR, dR, tL, tR, tC, tLs, tRs, vecEnd, g);
+    }
+
+    reference::coherentMatrix (hpL + vecEnd, hpR + vecEnd, dR != nullptr ? dR + vecEnd : nullptr,
+                               tL + vecEnd, tR + vecEnd, tC + vecEnd, tLs + vecEnd, tRs + vecEnd,
+                               numSamples - vecEnd,
+                               { g.centerGain.from (vecEnd), g.dialogBoost.from (vecEnd),
+                                 g.surroundBalance.from (vecEnd), g.frontWeight.from (vecEnd) });
+}
+
+void UpmixKernels::proLogicMatrix (const float* hpL, const float* hpR,
+                                   float* tL, float* tR, float* tC, float* tLs, float* tRs,
+                                   int numSamples, const ProLogicGains& g) noexcept
+{
+    const int vecEnd = vectorisableLength (numSamples);
+
+    if (g.surroundGain.isRamping() || g.centerWidth.isRamping())
+        proLogicImpl<true>  (hpL, hpR, tL, tR, tC, tLs, tRs, vecEnd, g);
+    else
+        proLogicImpl<false> (hpL, hpR, tL, tR, tC, tLs, tRs, vecEnd, g);
+
+    reference::proLogicMatrix (hpL + vecEnd, hpR + vecEnd,
+                               tL + vecEnd, tR + vecEnd, tC + vecEnd, tLs + vecEnd, tRs + vecEnd,
+                               numSamples - vecEnd,
+                               { g.surroundGain.from (vecEnd), g.centerWidth.from (vecEnd) });
+}
+
+void UpmixKernels::outputMix (const float* lpL, const float* lpR,
+                              const float* tL, const float* tR, const float* tC, const float* tLs, const float* tRs,
+                              float* outL, float* outR, float* outC, float* outLFE, float* outLs, float* outRs,
+                              int numSamples, GainRamp lfeGain) noexcept
+{
+    const int vecEnd = vectorisableLength (numSamples);
+
+    if (lfeGain.isRamping())
+        outputMixImpl<true>  (lpL, lpR, tL, tR, tC, tLs, tRs, outL, outR, outC, outLFE, outLs, outRs, vecEnd, lfeGain);
+    else
+        outputMixImpl<false> (lpL, lpR, tL, tR, tC, tLs, tRs, outL, outR, outC, outLFE, outLs, outRs, vecEnd, lfeGain);
+
+    reference::outputMix (lpL + vecEnd, lpR + vecEnd,
+                          tL + vecEnd, tR + vecEnd, tC + vecEnd, tLs + vecEnd, tRs + vecEnd,
+                          outL + vecEnd, outR + vecEnd, outC + vecEnd, outLFE + vecEnd, outLs + vecEnd, outRs + vecEnd,
+                          numSamples - vecEnd, lfeGain.from (vecEnd));
+}
+
+//==============================================================================
+namespace
+{
+    constexpr float neo6Alpha = 0.9995f;
+
+    /** Gewichte des Einpol-Glätters über ein Intervall von Interval Samples:
+        s[K] = alpha^K * s[0] + sum_i (1 - alpha) * alpha^(K-1-i) * t[i]
+        constexpr: die Tabelle steht schon im Binary, nichts wird beim ersten Block gebaut.
+    */
+    template <int Interval>
+    struct Neo6SmootherTable
+    {
+        constexpr Neo6SmootherTable() noexcept
+        {
+            double a = 1.0;
+            for (int i = Interval - 1; i >= 0; --i)
+            {
+                weights[i] = (float) ((1.0 - (double) neo6Alpha) * a);
+                a *= (double) neo6Alpha;
+            }
+
+            decay = (float) a;
+
+            for (int i = 0; i < Interval; ++i)
+                ramp[i] = (float) (i + 1) / (float) Interval;
+        }
+
+        alignas (64) float weights[Interval] {};
+        alignas (64) float ramp[Interval] {};
+        float decay = 1.0f;
+    };
+
+    struct Neo6SteerGains
+    {
+        float c, lr, s;
+    };
+
+    UPMIX_INLINE Neo6SteerGains neo6GainsForSteer (float steer, float centerWidth) noexcept
+    {
+        if (steer > 0.0f)
+        {
+            const float bleed = centerWidth > 0.0f ? steer * centerWidth : 0.0f;
+            return { steer - bleed, (1.0f - steer) + bleed, 0.0f };
+        }
+
+        return { 0.0f, 1.0f + steer, -steer };
+    }
+
+    template <int Interval>
+    void neo6ControlRateImpl (const float* UPMIX_RESTRICT inL, const float* UPMIX_RESTRICT inR,
+                              float* UPMIX_RESTRICT outL, float* UPMIX_RESTRICT outR, float* UPMIX_RESTRICT outC,
+                              float* UPMIX_RESTRICT outLs, float* UPMIX_RESTRICT outRs,
+                              int numSamples, const UpmixKernels::Neo6Gains& g, float& steerState) noexcept
+    {
+        static_assert (Interval % VecF::size == 0, "Intervall muss ein Vielfaches der SIMD-Breite sein");
+        static constexpr Neo6SmootherTable<Interval> table {};
+
+        const auto k0707   = broadcast (0.707f);
+        const auto epsilon = broadcast (0.0001f);
+
+        // surroundGain läuft pro Sample (ggf. als Rampe), centerWidth fließt an
+        // den Stützstellen in die Gains ein und wird dazwischen mit interpoliert.
+        const VecGain<true> surr (g.surroundGain);
+
+        float steer = steerState;
+        auto gainsStart = neo6GainsForSteer (steer, g.centerWidth.at (0));
+
+        const int controlEnd = numSamples - (numSamples % Interval);
+
+        for (int start = 0; start < controlEnd; start += Interval)
+        {
+            const float* l = inL + start;
+            const float* r = inR + start;
+
+            // 1) Steuerzustand am Intervallende: gewichtete Summe der Zielwerte
+            auto acc = broadcast (0.0f);
+
+            for (int i = 0; i < Interval; i += VecF::size)
+            {
+                const auto vl = load (l + i);
+                const auto vr = load (r + i);
+                const auto absSum  = abs ((vl + vr) * k0707);
+                const auto absDiff = abs ((vl - vr) * k0707) + epsilon;
+                acc = acc + ((absSum - absDiff) / (absSum + absDiff)) * load (table.weights + i);
+            }
+
+            steer = table.decay * steer + simd::sum (acc);
+            const auto gainsEnd = neo6GainsForSteer (steer, g.centerWidth.at (start + Interval - 1));
+
+            // 2) Gains linear über das Intervall rampen und anwenden
+            const auto c0  = broadcast (gainsStart.c),  dc  = broadcast (gainsEnd.c  - gainsStart.c);
+            const auto lr0 = broadcast (gainsStart.lr), dlr = broadcast (gainsEnd.lr - gainsStart.lr);
+            const auto s0  = broadcast (gainsStart.s),  ds  = broadcast (gainsEnd.s  - gainsStart.s);
+
+            for (int i = 0; i < Interval; i += VecF::size)
+            {
+                const int n = start + i;
+                const auto ramp = load (table.ramp + i);
+                const auto vl = load (inL + n);
+                const auto vr = load (inR + n);
+                const auto vsum  = (vl + vr) * k0707;
+                const auto vdiff = (vl - vr) * k0707;
+
+                const auto cGain  = c0  + dc  * ramp;
+                const auto lrGain = lr0 + dlr * ramp;
+                const auto sDiff  = vdiff * (s0 + ds * ramp) * surr.at (n);
+
+                store (outC  + n, load (outC  + n) + vsum * cGain);
+                store (outLs + n, load (outLs + n) + sDiff);
+                store (outRs + n, load (outRs + n) - sDiff);
+                store (outL  + n, load (outL  + n) + vl * lrGain);
+                store (outR  + n, load (outR  + n) + vr * lrGain);
+            }
+
+            gainsStart = gainsEnd;
+        }
+
+        steerState = steer;
+
+        // Rest (kürzer als ein Intervall) exakt pro Sample
+        UpmixKernels::reference::neo6Band (inL + controlEnd, inR + controlEnd,
+                                           outL + controlEnd, outR + controlEnd, outC + controlEnd,
+                                           outLs + controlEnd, outRs + controlEnd,
+                                           numSamples - controlEnd,
+                                           { g.surroundGain.from (controlEnd), g.centerWidth.from (controlEnd) },
+                                           steerState);
+    }
+}
+
+void UpmixKernels::neo6BandControlRate (const float* inL, const float* inR,
+                                        float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                                        int numSamples, const Neo6Gains& gains,
+                                        Neo6SteeringInterval interval, float& steerState) noexcept
+{
+    switch (interval)
+    {
+        case neo6SteerEvery16:
+            neo6ControlRateImpl<16> (inL, inR, outL, outR, outC, outLs, outRs, numSamples, gains, steerState);
+            break;
+
+        case neo6SteerEvery32:
+            neo6ControlRateImpl<32> (inL, inR, outL, outR, outC, outLs, outRs, numSamples, gains, steerState);
+            break;
+
+        case neo6SteerPerSample:
+        default:
+            reference::neo6Band (inL, inR, outL, outR, outC, outLs, outRs, numSamples, gains, steerState);
+            break;
+    }
+}
+
+//==============================================================================
+namespace
+{
+    template <bool withDialog, bool Ramped>
+    void transientImpl (const float* UPMIX_RESTRICT hpL, const float* UPMIX_RESTRICT hpR,
+                        float* UPMIX_RESTRICT tL, float* UPMIX_RESTRICT tR, float* UPMIX_RESTRICT tC,
+                        float* UPMIX_RESTRICT tLs, float* UPMIX_RESTRICT tRs,
+                        int numSamples, const UpmixKernels::TransientGains& g,
+                        UpmixKernels::TransientState& st) noexcept
+    {
+        const auto att       = broadcastPair (0.9f);
+        const auto rel       = broadcastPair (0.999f);
+        const auto oneMinRel = broadcastPair (1.0f - 0.999f);
+        const auto zero      = broadcastPair (0.0f);
+        const auto one       = broadcastPair (1.0f);
+        const auto four      = broadcastPair (4.0f);
+        const auto surrBoost = broadcastPair (1.5f);
+
+        auto front    = broadcastPair (g.frontWeight.start);
+        auto surround = broadcastPair (g.surroundBalance.start);
+        float centerGain    = g.centerGain.start;
+        float dialogExtract = g.dialogExtract.start;
+
+        // Lane 0 = links, Lane 1 = rechts
+        auto fastEnv = makePair (st.fastEnvL, st.fastEnvR);
+        auto slowEnv = makePair (st.slowEnvL, st.slowEnvR);
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            if constexpr (Ramped)
+            {
+                front         = broadcastPair (g.frontWeight.at (n));
+                surround      = broadcastPair (g.surroundBalance.at (n));
+                centerGain    = g.centerGain.at (n);
+                dialogExtract = std::max (0.0f, g.dialogExtract.at (n));
+            }
+
+            const float l = hpL[n];
+            const float r = hpR[n];
+
+            const auto x    = makePair (l, r);
+            const auto absX = abs (x);
+
+            fastEnv = select (greaterThan (absX, fastEnv), absX, fastEnv * att);
+            slowEnv = select (greaterThan (absX, slowEnv), absX, (slowEnv * rel) + (absX * oneMinRel));
+
+            const auto ratio = min (max (fastEnv - slowEnv, zero) * four, one);
+            const auto sus   = one - ratio;
+
+            const auto frontOut = x * (ratio + (sus * front));
+            const auto surr     = ((x * sus) * surround) * surrBoost;
+
+            const float monoSum = (l + r) * 0.5f;
+            float c = monoSum * ((first (sus) + second (sus)) * 0.5f) * centerGain;
+
+            if constexpr (withDialog)
+                c += monoSum * dialogExtract;
+
+            tC[n]  = c;
+            tL[n]  = first (frontOut);
+            tR[n]  = second (frontOut);
+            tLs[n] = first (surr);
+            tRs[n] = second (surr);
+        }
+
+        st.fastEnvL = first (fastEnv);  st.fastEnvR = second (fastEnv);
+        st.slowEnvL = first (slowEnv);  st.slowEnvR = second (slowEnv);
+    }
+}
+
+void UpmixKernels::transientMatrix (const float* hpL, const float* hpR,
+                                    float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                                    int numSamples, const TransientGains& gains, TransientState& state) noexcept
+{
+    const bool ramped = gains.centerGain.isRamping() || gains.frontWeight.isRamping()
+                     || gains.surroundBalance.isRamping() || gains.dialogExtract.isRamping();
+
+    if (ramped)
+    {
+        // Bei einer Dialog-Rampe muss der Pfad mit Dialog laufen (0 * x ändert nichts)
+        if (gains.dialogExtract.start > 0.0f || gains.dialogExtract.at (numSamples - 1) > 0.0f)
+            transientImpl<true, true>  (hpL, hpR, outL, outR, outC, outLs, outRs, numSamples, gains, state);
+        else
+            transientImpl<false, true> (hpL, hpR, outL, outR, outC, outLs, outRs, numSamples, gains, state);
+    }
+    else if (gains.dialogExtract.start > 0.0f)
+    {
+        transientImpl<true, false>  (hpL, hpR, outL, outR, outC, outLs, outRs, numSamples, gains, state);
+    }
+    else
+    {
+        transientImpl<false, false> (hpL, hpR, outL, outR, outC, outLs, outRs, numSamples, gains, state);
+    }
+}
+
+//==============================================================================
+namespace
+{
+    constexpr float spectralEpsilon = 1.0e-20f;
+
+    /** Ein Bin - gemeinsam für Referenz und Rest-Bins der SIMD-Variante. */
+    inline void spectralBin (int k, const float* lRe, const float* lIm, const float* rRe, const float* rIm,
+                             float* powerL, float* powerR, float* crossRe, float* crossIm,
+                             float* directGain, float* crossGain, float* centerGain, float* ambienceGain,
+                             const UpmixKernels::SpectralGains& g) noexcept
+    {
+        const float a = g.smoothing, b = 1.0f - g.smoothing;
+
+        const float pl = powerL[k]  = a * powerL[k]  + b * (lRe[k] * lRe[k] + lIm[k] * lIm[k]);
+        const float pr = powerR[k]  = a * powerR[k]  + b * (rRe[k] * rRe[k] + rIm[k] * rIm[k]);
+        const float cr = crossRe[k] = a * crossRe[k] + b * (lRe[k] * rRe[k] + lIm[k] * rIm[k]);
+        const float ci = crossIm[k] = a * crossIm[k] + b * (lIm[k] * rRe[k] - lRe[k] * rIm[k]);
+
+        const float cross2    = cr * cr + ci * ci;
+        const float sum       = pl + pr + spectralEpsilon;
+        const float coherence = std::min (1.0f, cross2 / (pl * pr + spectralEpsilon));
+        const float pan       = (pl - pr) / sum;
+        const float direct2   = std::max (coherence, pan * pan);
+
+        const float direct     = std::sqrt (direct2);
+        const float ambience   = std::sqrt (1.0f - direct2);
+        const float similarity = std::min (1.0f, 2.0f * std::sqrt (cross2) / sum);
+        const float sim2       = similarity * similarity;
+        const float center     = similarity * (sim2 + (1.0f - sim2) * g.dialogExtract);
+
+        directGain[k]   = direct * (1.0f - 0.5f * center) + g.frontAmbience * ambience;
+        crossGain[k]    = -0.5f * center * direct;
+        centerGain[k]   = 0.70710678f * center * direct;
+        ambienceGain[k] = g.surroundGain * ambience;
+    }
+}
+
+void UpmixKernels::reference::spectralWeights (const float* lRe, const float* lIm, const float* rRe, const float* rIm,
+                                               float* powerL, float* powerR, float* crossRe, float* crossIm,
+                                               float* directGain, float* crossGain, float* centerGain, float* ambienceGain,
+                                               int numBins, const SpectralGains& gains) noexcept
+{
+    for (int k = 0; k < numBins; ++k)
+        spectralBin (k, lRe, lIm, rRe, rIm, powerL, powerR, crossRe, crossIm,
+                     directGain, crossGain, centerGain, ambienceGain, gains);
+}
+
+void UpmixKernels::spectralWeights (const float* lRe, const float* lIm, const float* rRe, const float* rIm,
+                                    float* powerL, float* powerR, float* crossRe, float* crossIm,
+                                    float* directGain, float* crossGain, float* centerGain, float* ambienceGain,
+                                    int numBins, const SpectralGains& g) noexcept
+{
+    const auto a = broadcast (g.smoothing), b = broadcast (1.0f - g.smoothing);
+    const auto zero = broadcast (0.0f), one = broadcast (1.0f), half = broadcast (0.5f), two = broadcast (2.0f);
+    const auto eps = broadcast (spectralEpsilon);
+    const auto extract = broadcast (g.dialogExtract);
+    const auto front = broadcast (g.frontAmbience), rear = broadcast (g.surroundGain);
+    const auto invSqrt2 = broadcast (0.70710678f);
+
+    const int vecEnd = vectorisableLength (numBins);
+
+    for (int k = 0; k < vecEnd; k += VecF::size)
+    {
+        const auto lr = load (lRe + k), li = load (lIm + k);
+        const auto rr = load (rRe + k), ri = load (rIm + k);
+
+        const auto pl = a * load (powerL + k)  + b * (lr * lr + li * li);
+        const auto pr = a * load (powerR + k)  + b * (rr * rr + ri * ri);
+        const auto cr = a * load (crossRe + k) + b * (lr * rr + li * ri);
+        const auto ci = a * load (crossIm + k) + b * (li * rr - lr * ri);
+        store (powerL + k, pl);
+        store (powerR + k, pr);
+        store (crossRe + k, cr);
+        store (crossIm + k, ci);
+
+        const auto cross2    = cr * cr + ci * ci;
+        const auto sumPower  = pl + pr + eps;
+        const auto coherence = min (one, cross2 / (pl * pr + eps));
+        const auto pan       = (pl - pr) / sumPower;
+        const auto direct2   = max (coherence, pan * pan);
+
+        const auto direct     = sqrt (direct2);
+        const auto ambience   = sqrt (max (zero, one - direct2));
+        const auto similarity = min (one, two * sqrt (cross2) / sumPower);
+        const auto sim2       = similarity * similarity;
+        const auto center     = similarity * (sim2 + (one - sim2) * extract);
+
+        store (directGain + k,   direct * (one - half * center) + front * ambience);
+        store (crossGain + k,    zero - half * center * direct);
+        store (centerGain + k,   invSqrt2 * center * direct);
+        store (ambienceGain + k, rear * ambience);
+    }
+
+    for (int k = vecEnd; k < numBins; ++k)
+        spectralBin (k, lRe, lIm, rRe, rIm, powerL, powerR, crossRe, crossIm,
+                     directGain, crossGain, centerGain, ambienceGain, g);
+}
+
+//==============================================================================
+namespace
+{
+    constexpr float pcaEpsilon = 1.0e-12f;
+
+    /** Ziel-Matrix eines Bandes aus seiner Kovarianz [[a, c], [c, b]].
+
+        Projektion auf den Haupt-Eigenvektor, gewichtet mit der Direktheit
+        r = (l1 - l2) / (l1 + l2):  r * [[cos², cs], [cs, sin²]]
+        mit cos2t = (a - b) / D, sin2t = 2c / D, D = l1 - l2 = sqrt((a - b)² + 4c²).
+        Alles ohne Winkelfunktionen: nur eine Wurzel und zwei Divisionen.
+    */
+    inline void pcaTargets (float a, float b, float c, float surround, float front, float extract, float* m) noexcept
+    {
+        const float invSum = 1.0f / (a + b + pcaEpsilon);
+        const float d      = std::sqrt ((a - b) * (a - b) + 4.0f * c * c);
+
+        const float r   = d * invSum;
+        const float u   = (a - b) * invSum;
+        const float mLL = 0.5f * (r + u);
+        const float mRR = 0.5f * (r - u);
+        const float mLR = c * invSum;
+
+        // Mittigkeit der Hauptrichtung (sin2t), gegenphasig zählt nicht
+        const float width  = std::max (0.0f, 2.0f * c / (d + pcaEpsilon));
+        const float width2 = width * width;
+        const float center = width * (width2 + (1.0f - width2) * extract);
+        const float h = 0.5f * center, k = 0.70710678f * center;
+
+        const float sL = mLL + mLR, sR = mLR + mRR;
+
+        m[0] = mLL - h * sL + front * (1.0f - mLL);   // L  aus Band-L
+        m[1] = mLR - h * sR - front * mLR;            // L  aus Band-R
+        m[2] = mLR - h * sL - front * mLR;            // R  aus Band-L
+        m[3] = mRR - h * sR + front * (1.0f - mRR);   // R  aus Band-R
+        m[4] = k * sL;                                // C
+        m[5] = k * sR;
+        m[6] = surround * (1.0f - mLL);               // Ls
+        m[7] = -surround * mLR;
+        m[8] = -surround * mLR;                       // Rs
+        m[9] = surround * (1.0f - mRR);
+    }
+
+    struct PcaFrameGains
+    {
+        float surround, front, extract;
+    };
+
+    inline PcaFrameGains pcaGainsAt (const UpmixKernels::PcaGains& g, int n) noexcept
+    {
+        const float surround = std::min (1.0f, std::max (0.0f, g.surroundGain.at (n)));
+        return { surround, std::sqrt (1.0f - surround * surround), g.dialogExtract.at (n) };
+    }
+
+    /** Neue Zielmatrix, Rampe so, dass sie nach pcaControlInterval Samples erreicht ist. */
+    void pcaUpdateTargets (UpmixKernels::PcaState& st, const PcaFrameGains& g) noexcept
+    {
+        constexpr float invInterval = 1.0f / (float) UpmixKernels::pcaControlInterval;
+
+        for (int band = 0; band < st.numBands; ++band)
+        {
+            float target[UpmixKernels::PcaState::numMix];
+            pcaTargets (st.covLL[band], st.covRR[band], st.covLR[band], g.surround, g.front, g.extract, target);
+
+            for (int i = 0; i < UpmixKernels::PcaState::numMix; ++i)
+                st.mixStep[i][band] = (target[i] - st.mix[i][band]) * invInterval;
+        }
+    }
+}
+
+void UpmixKernels::preparePcaFilterbank (PcaState& state, double sampleRate, int numBands) noexcept
+{
+    state = {};
+    state.numBands = numBands > 8 ? PcaState::maxBands : 8;
+
+    // K - 1 Tiefpässe, logarithmisch verteilt; die letzte Lane lässt x durch
+    const int numLowPasses = state.numBands - 1;
+    const double lowest  = 200.0;
+    const double highest = std::min (10000.0, 0.4 * sampleRate);
+
+    for (int k = 0; k < numLowPasses; ++k)
+    {
+        const double fc    = lowest * std::pow (highest / lowest, (double) k / (double) (numLowPasses - 1));
+        const double w0    = 2.0 * 3.14159265358979323846 * fc / sampleRate;
+        const double cosW  = std::cos (w0);
+        const double alpha = std::sin (w0) / (2.0 * 0.70710678118654752);
+        const double a0    = 1.0 + alpha;
+
+        state.b0[k] = (float) ((1.0 - cosW) * 0.5 / a0);
+        state.b1[k] = (float) ((1.0 - cosW) / a0);
+        state.b2[k] = state.b0[k];
+        state.a1[k] = (float) (-2.0 * cosW / a0);
+        state.a2[k] = (float) ((1.0 - alpha) / a0);
+    }
+
+    state.b0[numLowPasses] = 1.0f;
+
+    state.covarianceSmoothing = (float) (1.0 - std::exp (-1.0 / (0.02 * sampleRate)));
+}
+
+void UpmixKernels::reference::pcaUpmix (const float* hpL, const float* hpR,
+                                        float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                                        int numSamples, const PcaGains& gains, PcaState& st) noexcept
+{
+    const float alpha = st.covarianceSmoothing;
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        if (st.samplesUntilUpdate == 0)
+        {
+            pcaUpdateTargets (st, pcaGainsAt (gains, n));
+            st.samplesUntilUpdate = pcaControlInterval;
+        }
+
+        --st.samplesUntilUpdate;
+
+        const float xL = hpL[n], xR = hpR[n];
+        float prevL = 0.0f, prevR = 0.0f;
+        float o[5] = {};
+
+        for (int k = 0; k < st.numBands; ++k)
+        {
+            const float yL = st.b0[k] * xL + st.s1L[k];
+            st.s1L[k] = st.b1[k] * xL - st.a1[k] * yL + st.s2L[k];
+            st.s2L[k] = st.b2[k] * xL - st.a2[k] * yL;
+
+            const float yR = st.b0[k] * xR + st.s1R[k];
+            st.s1R[k] = st.b1[k] * xR - st.a1[k] * yR + st.s2R[k];
+            st.s2R[k] = st.b2[k] * xR - st.a2[k] * yR;
+
+            const float bL = yL - prevL, bR = yR - prevR;
+            prevL = yL;
+            prevR = yR;
+
+            st.covLL[k] += alpha * (bL * bL - st.covLL[k]);
+            st.covRR[k] += alpha * (bR * bR - st.covRR[k]);
+            st.covLR[k] += alpha * (bL * bR - st.covLR[k]);
+
+            for (int out = 0; out < 5; ++out)
+                o[out] += st.mix[2 * out][k] * bL + st.mix[2 * out + 1][k] * bR;
+
+            for (int i = 0; i < PcaState::numMix; ++i)
+                st.mix[i][k] += st.mixStep[i][k];
+        }
+
+        outL[n] = o[0]; outR[n] = o[1]; outC[n] = o[2]; outLs[n] = o[3]; outRs[n] = o[4];
+    }
+}
+
+namespace
+{
+    /** Alle Bänder in NumVecs SIMD-Registern; Zustand lebt während des Blocks in Registern. */
+    template <int NumVecs>
+    void pcaImpl (const float* UPMIX_RESTRICT hpL, const float* UPMIX_RESTRICT hpR,
+                  float* UPMIX_RESTRICT outL, float* UPMIX_RESTRICT outR, float* UPMIX_RESTRICT outC,
+                  float* UPMIX_RESTRICT outLs, float* UPMIX_RESTRICT outRs,
+                  int numSamples, const UpmixKernels::PcaGains& gains, UpmixKernels::PcaState& st) noexcept
+    {
+        constexpr int W = VecF::size;
+        constexpr int numMix = UpmixKernels::PcaState::numMix;
+
+        VecF b0[NumVecs], b1[NumVecs], b2[NumVecs], a1[NumVecs], a2[NumVecs];
+        VecF s1L[NumVecs], s2L[NumVecs], s1R[NumVecs], s2R[NumVecs];
+        VecF cLL[NumVecs], cRR[NumVecs], cLR[NumVecs];
+        VecF mix[numMix][NumVecs];
+
+        auto loadState = [&]
+        {
+            for (int j = 0; j < NumVecs; ++j)
+            {
+                s1L[j] = load (st.s1L + j * W); s2L[j] = load (st.s2L + j * W);
+                s1R[j] = load (st.s1R + j * W); s2R[j] = load (st.s2R + j * W);
+                cLL[j] = load (st.covLL + j * W); cRR[j] = load (st.covRR + j * W); cLR[j] = load (st.covLR + j * W);
+
+                for (int i = 0; i < numMix; ++i)
+                    mix[i][j] = load (st.mix[i] + j * W);
+            }
+        };
+
+        auto storeState = [&]
+        {
+            for (int j = 0; j < NumVecs; ++j)
+            {
+                store (st.s1L + j * W, s1L[j]); store (st.s2L + j * W, s2L[j]);
+                store (st.s1R + j * W, s1R[j]); store (st.s2R + j * W, s2R[j]);
+                store (st.covLL + j * W, cLL[j]); store (st.covRR + j * W, cRR[j]); store (st.covLR + j * W, cLR[j]);
+
+                for (int i = 0; i < numMix; ++i)
+                    store (st.mix[i] + j * W, mix[i][j]);
+            }
+        };
+
+        for (int j = 0; j < NumVecs; ++j)
+        {
+            b0[j] = load (st.b0 + j * W); b1[j] = load (st.b1 + j * W); b2[j] = load (st.b2 + j * W);
+            a1[j] = load (st.a1 + j * W); a2[j] = load (st.a2 + j * W);
+        }
+
+        const auto alpha = broadcast (st.covarianceSmoothing);
+        const auto zero  = broadcast (0.0f);
+
+        // Tiefpass-Ausgänge mit einer Null davor: Band k = y[k] - y[k - 1] per versetztem Load
+        alignas (64) float yL[W + NumVecs * W] {};
+        alignas (64) float yR[W + NumVecs * W] {};
+
+        loadState();
+
+        for (int n = 0; n < numSamples;)
+        {
+            if (st.samplesUntilUpdate == 0)
+            {
+                // Stützstelle: Zielmatrix skalar pro Band (einmal pro Intervall, nicht pro Sample)
+                storeState();
+                pcaUpdateTargets (st, pcaGainsAt (gains, n));
+                st.samplesUntilUpdate = UpmixKernels::pcaControlInterval;
+            }
+
+            VecF step[numMix][NumVecs];
+
+            for (int i = 0; i < numMix; ++i)
+                for (int j = 0; j < NumVecs; ++j)
+                    step[i][j] = load (st.mixStep[i] + j * W);
+
+            const int runEnd = std::min (numSamples, n + st.samplesUntilUpdate);
+            st.samplesUntilUpdate -= runEnd - n;
+
+            for (; n < runEnd; ++n)
+            {
+                const auto xL = broadcast (hpL[n]), xR = broadcast (hpR[n]);
+
+                for (int j = 0; j < NumVecs; ++j)
+                {
+                    const auto vL = b0[j] * xL + s1L[j];
+                    s1L[j] = b1[j] * xL - a1[j] * vL + s2L[j];
+                    s2L[j] = b2[j] * xL - a2[j] * vL;
+                    store (yL + W + j * W, vL);
+
+                    const auto vR = b0[j] * xR + s1R[j];
+                    s1R[j] = b1[j] * xR - a1[j] * vR + s2R[j];
+                    s2R[j] = b2[j] * xR - a2[j] * vR;
+                    store (yR + W + j * W, vR);
+                }
+
+                auto oL = zero, oR = zero, oC = zero, oLs = zero, oRs = zero;
+
+                for (int j = 0; j < NumVecs; ++j)
+                {
+                    const auto bL = load (yL + W + j * W) - load (yL + W - 1 + j * W);
+                    const auto bR = load (yR + W + j * W) - load (yR + W - 1 + j * W);
+
+                    cLL[j] = cLL[j] + alpha * (bL * bL - cLL[j]);
+                    cRR[j] = cRR[j] + alpha * (bR * bR - cRR[j]);
+                    cLR[j] = cLR[j] + alpha * (bL * bR - cLR[j]);
+
+                    oL  = oL  + mix[0][j] * bL + mix[1][j] * bR;
+                    oR  = oR  + mix[2][j] * bL + mix[3][j] * bR;
+                    oC  = oC  + mix[4][j] * bL + mix[5][j] * bR;
+                    oLs = oLs + mix[6][j] * bL + mix[7][j] * bR;
+                    oRs = oRs + mix[8][j] * bL + mix[9][j] * bR;
+
+                    for (int i = 0; i < numMix; ++i)
+                        mix[i][j] = mix[i][j] + step[i][j];
+                }
+
+                outL[n] = sum (oL); outR[n] = sum (oR); outC[n] = sum (oC);
+                outLs[n] = sum (oLs); outRs[n] = sum (oRs);
+            }
+        }
+
+        storeState();
+    }
+}
+
+void UpmixKernels::pcaUpmix (const float* hpL, const float* hpR,
+                             float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                             int numSamples, const PcaGains& gains, PcaState& state) noexcept
+{
+    static_assert (PcaState::maxBands % VecF::size == 0 && 8 % VecF::size == 0,
+                   "Bandzahl muss ein Vielfaches der SIMD-Breite sein");
+
+    if (state.numBands == PcaState::maxBands)
+        pcaImpl<PcaState::maxBands / VecF::size> (hpL, hpR, outL, outR, outC, outLs, outRs, numSamples, gains, state);
+    else
+        pcaImpl<8 / VecF::size> (hpL, hpR, outL, outR, outC, outLs, outRs, numSamples, gains, state);
+}
+
+//==============================================================================
+namespace
+{
+    /** Trapez-SVF mit g = tan(pi fc / fs) und Dämpfung k = 1/Q; Ausgang m0 x + m1 v1 + m2 v2. */
+    UpmixKernels::BiquadCoefficients trapezoidalSvf (double sampleRate, double frequency, double k,
+                                                     double m0, double m1, double m2) noexcept
+    {
+        const double g  = std::tan (3.14159265358979323846 * frequency / sampleRate);
+        const double a1 = 1.0 / (1.0 + g * (g + k));
+
+        return { (float) a1, (float) (g * a1), (float) (g * g * a1), (float) m0, (float) m1, (float) m2 };
+    }
+}
+
+UpmixKernels::BiquadCoefficients UpmixKernels::makeButterworthLowPass (double sampleRate, double frequency) noexcept
+{
+    return trapezoidalSvf (sampleRate, frequency, 1.41421356237309505, 0.0, 0.0, 1.0);
+}
+
+UpmixKernels::BiquadCoefficients UpmixKernels::makeButterworthHighPass (double sampleRate, double frequency) noexcept
+{
+    return trapezoidalSvf (sampleRate, frequency, 1.41421356237309505, 1.0, -1.41421356237309505, -1.0);
+}
+
+UpmixKernels::BiquadCoefficients UpmixKernels::makeBandPass (double sampleRate, double frequency, double q) noexcept
+{
+    return trapezoidalSvf (sampleRate, frequency, 1.0 / q, 0.0, 1.0 / q, 0.0);
+}
+
+void UpmixKernels::prepareBiquadBank (BiquadBank& bank, int numLanes, int numStages) noexcept
+{
+    bank = {};
+    bank.numLanes  = std::clamp (numLanes, 1, BiquadBank::maxLanes);
+    bank.numStages = std::clamp (numStages, 1, BiquadBank::maxStages);
+
+    // Ungenutzte Lanes bleiben komplett 0 (Ausgang 0), genutzte starten als Identität
+    for (int s = 0; s < bank.numStages; ++s)
+        for (int k = 0; k < bank.numLanes; ++k)
+            setBiquadStage (bank, k, s, {});
+}
+
+void UpmixKernels::setBiquadStage (BiquadBank& bank, int lane, int stage, const BiquadCoefficients& c) noexcept
+{
+    bank.a1[stage][lane] = c.a1;
+    bank.a2[stage][lane] = c.a2;
+    bank.a3[stage][lane] = c.a3;
+    bank.m0[stage][lane] = c.m0;
+    bank.m1[stage][lane] = c.m1;
+    bank.m2[stage][lane] = c.m2;
+}
+
+void UpmixKernels::resetBiquadBank (BiquadBank& bank) noexcept
+{
+    for (int s = 0; s < BiquadBank::maxStages; ++s)
+    {
+        std::fill (bank.s1[s], bank.s1[s] + BiquadBank::maxLanes, 0.0f);
+        std::fill (bank.s2[s], bank.s2[s] + BiquadBank::maxLanes, 0.0f);
+    }
+}
+
+namespace
+{
+    /** Abschnittslänge für das Umsortieren planar <-> Lanes (Stack, 32 x 8 Floats). */
+    constexpr int biquadFrameLength = 32;
+
+    using BiquadFrame = float[biquadFrameLength][UpmixKernels::BiquadBank::maxLanes];
+
+    void gatherLanes (const float* const* inputs, int numLanes, int offset, int n, BiquadFrame& frame) noexcept
+    {
+        for (int k = 0; k < numLanes; ++k)
+            for (int i = 0; i < n; ++i)
+                frame[i][k] = inputs[k][offset + i];
+    }
+
+    /** Lanes ohne Ausgang (nullptr) bleiben Zwischenergebnis. */
+    void scatterLanes (const BiquadFrame& frame, int numLanes, int offset, int n, float* const* outputs) noexcept
+    {
+        for (int k = 0; k < numLanes; ++k)
+            if (outputs[k] != nullptr)
+                for (int i = 0; i < n; ++i)
+                    outputs[k][offset + i] = frame[i][k];
+    }
+
+    void tapLanes (const BiquadFrame& trunk, const int* taps, int numLanes, int n, BiquadFrame& branch) noexcept
+    {
+        for (int i = 0; i < n; ++i)
+            for (int k = 0; k < numLanes; ++k)
+                branch[i][k] = trunk[i][taps[k]];
+    }
+
+    void referenceFrame (UpmixKernels::BiquadBank& bank, BiquadFrame& frame, int n) noexcept
+    {
+        for (int k = 0; k < bank.numLanes; ++k)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                float x = frame[i][k];
+
+                for (int s = 0; s < bank.numStages; ++s)
+                {
+                    float& s1 = bank.s1[s][k];
+                    float& s2 = bank.s2[s][k];
+
+                    const float v3 = x - s2;
+                    const float v1 = bank.a1[s][k] * s1 + bank.a2[s][k] * v3;
+                    const float v2 = s2 + bank.a2[s][k] * s1 + bank.a3[s][k] * v3;
+                    s1 = v1 + v1 - s1;
+                    s2 = v2 + v2 - s2;
+                    x = bank.m0[s][k] * x + bank.m1[s][k] * v1 + bank.m2[s][k] * v2;
+                }
+
+                frame[i][k] = x;
+            }
+        }
+    }
+}
+
+void UpmixKernels::reference::biquadBank (const float* const* inputs, float* const* outputs,
+                                          int numSamples, BiquadBank& bank) noexcept
+{
+    alignas (64) BiquadFrame frame {};
+
+    for (int offset = 0; offset < numSamples; offset += biquadFrameLength)
+    {
+        const int n = std::min (biquadFrameLength, numSamples - offset);
+        gatherLanes (inputs, bank.numLanes, offset, n, frame);
+        referenceFrame (bank, frame, n);
+        scatterLanes (frame, bank.numLanes, offset, n, outputs);
+    }
+}
+
+void UpmixKernels::reference::biquadBankTree (const float* const* inputs, float* const* trunkOutputs, BiquadBank& trunk,
+                                              const int* trunkTaps, float* const* branchOutputs, BiquadBank& branch,
+                                              int numSamples) noexcept
+{
+    alignas (64) BiquadFrame trunkFrame {};
+    alignas (64) BiquadFrame branchFrame {};
+
+    for (int offset = 0; offset < numSamples; offset += biquadFrameLength)
+    {
+        const int n = std::min (biquadFrameLength, numSamples - offset);
+        gatherLanes (inputs, trunk.numLanes, offset, n, trunkFrame);
+        referenceFrame (trunk, trunkFrame, n);
+        scatterLanes (trunkFrame, trunk.numLanes, offset, n, trunkOutputs);
+
+        tapLanes (trunkFrame, trunkTaps, branch.numLanes, n, branchFrame);
+        referenceFrame (branch, branchFrame, n);
+        scatterLanes (branchFrame, branch.numLanes, offset, n, branchOutputs);
+    }
+}
+
+namespace
+{
+    /** Koeffizienten und Zustand einer Bank in Registern: NumVecs Vektoren für alle Lanes,
+        NumStages Stufen. Pro Sample und Stufe: 7 mul, 8 add für bis zu VecF::size Lanes.
+    */
+    template <int NumVecs, int NumStages>
+    struct BiquadRegisters
+    {
+        static constexpr int W = VecF::size;
+
+        explicit BiquadRegisters (const UpmixKernels::BiquadBank& bank) noexcept
+        {
+            for (int s = 0; s < NumStages; ++s)
+            {
+                for (int j = 0; j < NumVecs; ++j)
+                {
+                    a1[s][j] = load (bank.a1[s] + j * W); a2[s][j] = load (bank.a2[s] + j * W); a3[s][j] = load (bank.a3[s] + j * W);
+                    m0[s][j] = load (bank.m0[s] + j * W); m1[s][j] = load (bank.m1[s] + j * W); m2[s][j] = load (bank.m2[s] + j * W);
+                    s1[s][j] = load (bank.s1[s] + j * W); s2[s][j] = load (bank.s2[s] + j * W);
+                }
+            }
+        }
+
+        void storeState (UpmixKernels::BiquadBank& bank) const noexcept
+        {
+            for (int s = 0; s < NumStages; ++s)
+            {
+                for (int j = 0; j < NumVecs; ++j)
+                {
+                    store (bank.s1[s] + j * W, s1[s][j]);
+                    store (bank.s2[s] + j * W, s2[s][j]);
+                }
+            }
+        }
+
+        /** Eine Zeile des Abschnitts (alle Lanes eines Samples) in-place. */
+        void processRow (float* row) noexcept
+        {
+            for (int j = 0; j < NumVecs; ++j)
+            {
+                auto x = load (row + j * W);
+
+                for (int s = 0; s < NumStages; ++s)
+                {
+                    const auto v3 = x - s2[s][j];
+                    const auto v1 = a1[s][j] * s1[s][j] + a2[s][j] * v3;
+                    const auto v2 = s2[s][j] + a2[s][j] * s1[s][j] + a3[s][j] * v3;
+                    s1[s][j] = v1 + v1 - s1[s][j];
+                    s2[s][j] = v2 + v2 - s2[s][j];
+                    x = m0[s][j] * x + m1[s][j] * v1 + m2[s][j] * v2;
+                }
+
+                store (row + j * W, x);
+            }
+        }
+
+        VecF a1[NumStages][NumVecs], a2[NumStages][NumVecs], a3[NumStages][NumVecs];
+        VecF m0[NumStages][NumVecs], m1[NumStages][NumVecs], m2[NumStages][NumVecs];
+        VecF s1[NumStages][NumVecs], s2[NumStages][NumVecs];
+    };
+
+    template <int Vecs, int Stages>
+    struct BankShape
+    {
+        static constexpr int numVecs = Vecs, numStages = Stages;
+    };
+
+    /** Ruft function (BankShape<...>{}) mit der zur Bank passenden Registerbelegung auf. */
+    template <typename Function>
+    void withBankShape (const UpmixKernels::BiquadBank& bank, Function&& function) noexcept
+    {
+        static_assert (UpmixKernels::BiquadBank::maxLanes % VecF::size == 0, "Lane-Zahl muss ein Vielfaches der SIMD-Breite sein");
+        static_assert (UpmixKernels::BiquadBank::maxStages == 2, "Dispatch kennt nur 1 oder 2 Stufen");
+
+        constexpr int allVecs = UpmixKernels::BiquadBank::maxLanes / VecF::size;
+
+        // Ungenutzte Stufen sind Identität, ungenutzte Lanes liefern 0 - nach oben aufrunden ist also exakt
+        if (bank.numLanes <= VecF::size)
+        {
+            if (bank.numStages == 1) function (BankShape<1, 1> {});
+            else                     function (BankShape<1, 2> {});
+        }
+        else
+        {
+            if (bank.numStages == 1) function (BankShape<allVecs, 1> {});
+            else                     function (BankShape<allVecs, 2> {});
+        }
+    }
+
+    template <int NumVecs, int NumStages>
+    void biquadBankImpl (const float* const* inputs, float* const* outputs,
+                         int numSamples, UpmixKernels::BiquadBank& bank) noexcept
+    {
+        BiquadRegisters<NumVecs, NumStages> regs (bank);
+
+        // Ungenutzte Lanes des Abschnitts bleiben 0
+        alignas (64) BiquadFrame frame {};
+
+        for (int offset = 0; offset < numSamples; offset += biquadFrameLength)
+        {
+            const int n = std::min (biquadFrameLength, numSamples - offset);
+            gatherLanes (inputs, bank.numLanes, offset, n, frame);
+
+            for (int i = 0; i < n; ++i)
+                regs.processRow (frame[i]);
+
+            scatterLanes (frame, bank.numLanes, offset, n, outputs);
+        }
+
+        regs.storeState (bank);
+    }
+
+    /** Stamm und Ast abschnittsweise nacheinander; der Ast liest den Stamm aus dem
+        Abschnitt im L1, Zwischenergebnisse landen nie in einem Puffer. Beide Bänke
+        im selben Sample-Durchlauf zu rechnen braucht doppelt so viele Register - mit
+        SSE2 nur gleich schnell, mit AVX2 (halb belegte Vektoren) 30 % langsamer.
+    */
+    template <int TrunkVecs, int TrunkStages, int BranchVecs, int BranchStages>
+    void biquadBankTreeImpl (const float* const* inputs, float* const* trunkOutputs, UpmixKernels::BiquadBank& trunk,
+                             const int* trunkTaps, float* const* branchOutputs, UpmixKernels::BiquadBank& branch,
+                             int numSamples) noexcept
+    {
+        BiquadRegisters<TrunkVecs, TrunkStages> trunkRegs (trunk);
+        BiquadRegisters<BranchVecs, BranchStages> branchRegs (branch);
+
+        alignas (64) BiquadFrame trunkFrame {};
+        alignas (64) BiquadFrame branchFrame {};
+
+        for (int offset = 0; offset < numSamples; offset += biquadFrameLength)
+        {
+            const int n = std::min (biquadFrameLength, numSamples - offset);
+            gatherLanes (inputs, trunk.numLanes, offset, n, trunkFrame);
+
+            for (int i = 0; i < n; ++i)
+                trunkRegs.processRow (trunkFrame[i]);
+
+            tapLanes (trunkFrame, trunkTaps, branch.numLanes, n, branchFrame);
+
+            for (int i = 0; i < n; ++i)
+                branchRegs.processRow (branchFrame[i]);
+
+            scatterLanes (trunkFrame, trunk.numLanes, offset, n, trunkOutputs);
+            scatterLanes (branchFrame, branch.numLanes, offset, n, branchOutputs);
+        }
+
+        trunkRegs.storeState (trunk);
+        branchRegs.storeState (branch);
+    }
+}
+
+void UpmixKernels::biquadBank (const float* const* inputs, float* const* outputs, int numSamples, BiquadBank& bank) noexcept
+{
+    withBankShape (bank, [&] (auto shape)
+    {
+        using Shape = decltype (shape);
+        biquadBankImpl<Shape::numVecs, Shape::numStages> (inputs, outputs, numSamples, bank);
+    });
+}
+
+void UpmixKernels::biquadBankTree (const float* const* inputs, float* const* trunkOutputs, BiquadBank& trunk,
+                                   const int* trunkTaps, float* const* branchOutputs, BiquadBank& branch,
+                                   int numSamples) noexcept
+{
+    withBankShape (trunk, [&] (auto trunkShape)
+    {
+        withBankShape (branch, [&] (auto branchShape)
+        {
+            using T = decltype (trunkShape);
+            using B = decltype (branchShape);
+            biquadBankTreeImpl<T::numVecs, T::numStages, B::numVecs, B::numStages> (inputs, trunkOutputs, trunk, trunkTaps,
+                                                                                    branchOutputs, branch, numSamples);
+        });
+    });
+}
+
+//==============================================================================
+void UpmixKernels::reference::schroederAllpass (float* data, float* ring, int numSamples, float gain) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float delayed = ring[i];
+        const float w = data[i] + gain * delayed;
+        data[i] = delayed - gain * w;
+        ring[i] = w;
+    }
+}
+
+void UpmixKernels::schroederAllpass (float* data, float* ring, int numSamples, float gain) noexcept
+{
+    const auto g = broadcast (gain);
+    const int vecEnd = vectorisableLength (numSamples);
+
+    for (int i = 0; i < vecEnd; i += VecF::size)
+    {
+        const auto delayed = load (ring + i);
+        const auto w = load (data + i) + g * delayed;
+        store (data + i, delayed - g * w);
+        store (ring + i, w);
+    }
+
+    reference::schroederAllpass (data + vecEnd, ring + vecEnd, numSamples - vecEnd, gain);
+}
+
+//==============================================================================
+namespace
+{
+    constexpr int truePeakPhases = 4;
+
+    /** Polyphasen des 4x-Interpolators: Prototyp sinc((m - 32) / 4) mit Blackman-Fenster
+        über truePeakTaps * 4 Koeffizienten, Phase p = Koeffizienten p, p + 4, ... (Phase 0
+        wäre die Identität und wird nicht gebraucht).
+    */
+    struct TruePeakTable
+    {
+        TruePeakTable() noexcept
+        {
+            constexpr int length = UpmixKernels::truePeakTaps * truePeakPhases;
+            constexpr double pi = 3.14159265358979323846;
+
+            for (int phase = 1; phase < truePeakPhases; ++phase)
+            {
+                for (int k = 0; k < UpmixKernels::truePeakTaps; ++k)
+                {
+                    const int m = k * truePeakPhases + phase;   // Zeitpunkt x[i - taps/2 + phase/4]
+                    const double x = (double) (m - length / 2) / truePeakPhases;
+                    const double sinc = x == 0.0 ? 1.0 : std::sin (pi * x) / (pi * x);
+                    const double window = 0.42 - 0.5 * std::cos (2.0 * pi * m / length) + 0.08 * std::cos (4.0 * pi * m / length);
+                    coefficients[phase - 1][k] = (float) (sinc * window);
+                }
+            }
+        }
+
+        alignas (64) float coefficients[truePeakPhases - 1][UpmixKernels::truePeakTaps];
+    };
+
+    const TruePeakTable& getTruePeakTable() noexcept
+    {
+        static const TruePeakTable table;
+        return table;
+    }
+}
+
+void UpmixKernels::prepareTruePeak() noexcept
+{
+    getTruePeakTable();
+}
+
+void UpmixKernels::reference::accumulatePeak (const float* data, float* peak, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        peak[i] = std::max (peak[i], std::abs (data[i]));
+}
+
+void UpmixKernels::accumulatePeak (const float* data, float* peak, int numSamples) noexcept
+{
+    const int vecEnd = vectorisableLength (numSamples);
+
+    for (int i = 0; i < vecEnd; i += VecF::size)
+        store (peak + i, max (load (peak + i), abs (load (data + i))));
+
+    reference::accumulatePeak (data + vecEnd, peak + vecEnd, numSamples - vecEnd);
+}
+
+void UpmixKernels::reference::accumulateTruePeak (const float* history, float* peak, int numSamples) noexcept
+{
+    const auto& table = getTruePeakTable();
+    const float* x = history + truePeakTaps - 1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float p = std::max (peak[i], std::abs (x[i - truePeakTaps / 2]));
+
+        for (int phase = 0; phase < truePeakPhases - 1; ++phase)
+        {
+            float y = 0.0f;
+
+            for (int k = 0; k < truePeakTaps; ++k)
+                y += table.coefficients[phase][k] * x[i - k];
+
+            p = std::max (p, std::abs (y));
+        }
+
+        peak[i] = p;
+    }
+}
+
+void UpmixKernels::accumulateTruePeak (const float* history, float* peak, int numSamples) noexcept
+{
+    const auto& table = getTruePeakTable();
+    const float* x = history + truePeakTaps - 1;
+    const int vecEnd = vectorisableLength (numSamples);
+
+    // Über die Zeit vektorisiert: jeder Tap ist ein versetzter Load derselben Historie
+    for (int i = 0; i < vecEnd; i += VecF::size)
+    {
+        auto p = max (load (peak + i), abs (load (x + i - truePeakTaps / 2)));
+
+        for (int phase = 0; phase < truePeakPhases - 1; ++phase)
+        {
+            auto y = broadcast (0.0f);
+
+            for (int k = 0; k < truePeakTaps; ++k)
+                y = y + broadcast (table.coefficients[phase][k]) * load (x + i - k);
+
+            p = max (p, abs (y));
+        }
+
+        store (peak + i, p);
+    }
+
+    reference::accumulateTruePeak (history + vecEnd, peak + vecEnd, numSamples - vecEnd);
+}
+
+//==============================================================================
+void UpmixKernels::reference::measureLevel (const float* data, int numSamples, double& sumOfSquares, float& peak) noexcept
+{
+    for (int n = 0; n < numSamples; ++n)
+    {
+        sumOfSquares += (double) data[n] * (double) data[n];
+        peak = std::max (peak, std::abs (data[n]));
+    }
+}
+
+void UpmixKernels::measureLevel (const float* data, int numSamples, double& sumOfSquares, float& peak) noexcept
+{
+    // Zwei unabhängige Akkumulatoren, damit die Additionen nicht aufeinander warten.
+    // Die Blocksumme bleibt in float (max. ein Chunk), erst danach wird in double addiert.
+    const int step   = 2 * VecF::size;
+    const int vecEnd = numSamples - numSamples % step;
+
+    auto sq0 = broadcast (0.0f), sq1 = broadcast (0.0f);
+    auto pk0 = broadcast (0.0f), pk1 = broadcast (0.0f);
+
+    for (int n = 0; n < vecEnd; n += step)
+    {
+        const auto x0 = load (data + n);
+        const auto x1 = load (data + n + VecF::size);
+        sq0 = sq0 + x0 * x0;
+        sq1 = sq1 + x1 * x1;
+        pk0 = max (pk0, abs (x0));
+        pk1 = max (pk1, abs (x1));
+    }
+
+    float lanes[VecF::size];
+    store (lanes, max (pk0, pk1));
+
+    for (float lane : lanes)
+        peak = std::max (peak, lane);
+
+    sumOfSquares += (double) sum (sq0 + sq1);
+
+    reference::measureLevel (data + vecEnd, numSamples - vecEnd, sumOfSquares, peak);
+}
+
+void UpmixKernels::reference::delayApplyGain (float* data, float* ring, const float* gain, int numSamples,
+                                              double* sumOfSquares, float* peak) noexcept
+{
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const float delayed = ring[n];
+        ring[n] = data[n];
+        data[n] = gain != nullptr ? delayed * gain[n] : delayed;
+    }
+
+    if (sumOfSquares != nullptr)
+        measureLevel (data, numSamples, *sumOfSquares, *peak);
+}
+
+namespace
+{
+    template <bool ApplyGain, bool Measure>
+    void delayApplyGainImpl (float* UPMIX_RESTRICT data, float* UPMIX_RESTRICT ring, const float* UPMIX_RESTRICT gain,
+                             int numSamples, double* sumOfSquares, float* peak) noexcept
+    {
+        // Wie measureLevel: zwei Akkumulatoren, Blocksumme in float, danach in double
+        const int step   = 2 * VecF::size;
+        const int vecEnd = numSamples - numSamples % step;
+
+        auto sq0 = broadcast (0.0f), sq1 = broadcast (0.0f);
+        auto pk0 = broadcast (0.0f), pk1 = broadcast (0.0f);
+
+        for (int n = 0; n < vecEnd; n += step)
+        {
+            auto y0 = load (ring + n);
+            auto y1 = load (ring + n + VecF::size);
+            store (ring + n,              load (data + n));
+            store (ring + n + VecF::size, load (data + n + VecF::size));
+
+            if constexpr (ApplyGain)
+            {
+                y0 = y0 * load (gain + n);
+                y1 = y1 * load (gain + n + VecF::size);
+            }
+
+            store (data + n,              y0);
+            store (data + n + VecF::size, y1);
+
+            if constexpr (Measure)
+            {
+                sq0 = sq0 + y0 * y0;
+                sq1 = sq1 + y1 * y1;
+                pk0 = max (pk0, abs (y0));
+                pk1 = max (pk1, abs (y1));
+            }
+        }
+
+        if constexpr (Measure)
+        {
+            float lanes[VecF::size];
+            store (lanes, max (pk0, pk1));
+
+            for (float lane : lanes)
+                *peak = std::max (*peak, lane);
+
+            *sumOfSquares += (double) sum (sq0 + sq1);
+        }
+
+        UpmixKernels::reference::delayApplyGain (data + vecEnd, ring + vecEnd, ApplyGain ? gain + vecEnd : nullptr,
+                                                 numSamples - vecEnd, sumOfSquares, peak);
+    }
+}
+
+void UpmixKernels::delayApplyGain (float* data, float* ring, const float* gain, int numSamples,
+                                   double* sumOfSquares, float* peak) noexcept
+{
+    if (gain != nullptr)
+    {
+        if (sumOfSquares != nullptr)  delayApplyGainImpl<true, true>   (data, ring, gain, numSamples, sumOfSquares, peak);
+        else                          delayApplyGainImpl<true, false>  (data, ring, gain, numSamples, nullptr, nullptr);
+    }
+    else
+    {
+        if (sumOfSquares != nullptr)  delayApplyGainImpl<false, true>  (data, ring, nullptr, numSamples, sumOfSquares, peak);
+        else                          delayApplyGainImpl<false, false> (data, ring, nullptr, numSamples, nullptr, nullptr);
+    }
+}
@@ -0,0 +1,409 @@
+/*
+==============================================================================
+    UpmixKernels.h
+
+    Vektorisierte Matrix-Kernels für processBlock. Jeder Kernel liest und
+    schreibt alle beteiligten planaren Streams in EINEM Durchlauf.
+
+    Zu jedem Kernel gibt es in UpmixKernels::reference die skalare
+    Originalschleife. Die SIMD-Variante muss pro Sample innerhalb von
+    UpmixKernels::tolerance (relativ zu max(1, |Referenz|)) bleiben -
+    Abweichungen entstehen nur durch FMA-Kontraktion des Compilers.
+
+    Alle Gains sind GainRamps: konstant (Normalfall, eigener schneller Pfad)
+    oder als lineare Rampe pro Sample, solange ein Parameter geglättet wird.
+==============================================================================
+*/
+
+#pragma once
+
+namespace UpmixKernels
+{
+    /** Erlaubte Abweichung SIMD vs. skalare Referenz (relativ, ab Betrag 1). */
+    constexpr float tolerance = 1.0e-6f;
+
+    /** Name des zur Compile-Zeit gewählten Befehlssatzes ("AVX2", "SSE2", "NEON", "Scalar"). */
+    const char* getInstructionSetName() noexcept;
+
+    //==============================================================================
+    /** Gain, der über den Block linear laufen darf: Sample n bekommt start + n * step. */
+    struct GainRamp
+    {
+        GainRamp (float constantValue = 0.0f) noexcept : start (constantValue) {}
+        GainRamp (float startValue, float stepPerSample) noexcept : start (startValue), step (stepPerSample) {}
+
+        float at (int n) const noexcept             { return start + step * (float) n; }
+        bool isRamping() const noexcept             { return step != 0.0f; }
+
+        /** Dieselbe Rampe, aber ab Sample n gezählt (für Rest-Samples). */
+        GainRamp from (int n) const noexcept        { return { at (n), step }; }
+
+        /** a * Rampe + b - für Gains, die linear aus einem Parameter abgeleitet sind. */
+        GainRamp mapped (float a, float b) const noexcept { return { a * start + b, a * step }; }
+
+        float start = 0.0f;
+        float step  = 0.0f;
+    };
+
+    //==============================================================================
+    struct CoherentGains
+    {
+        GainRamp centerGain;
+        GainRamp dialogBoost;
+        GainRamp surroundBalance;
+        GainRamp frontWeight;
+    };
+
+    /** Coherent-Modus: monoMid-Matrix plus gefiltertes Dialog-Signal in den Center.
+        dialog == nullptr: Dialog-Anhebung aus, der Center ist nur die monoMid-Matrix.
+    */
+    void coherentMatrix (const float* hpL, const float* hpR, const float* dialog,
+                         float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                         int numSamples, const CoherentGains& gains) noexcept;
+
+    //==============================================================================
+    struct ProLogicGains
+    {
+        GainRamp surroundGain;
+        GainRamp centerWidth;
+    };
+
+    /** Pro Logic II: Summen-/Differenzmatrix. */
+    void proLogicMatrix (const float* hpL, const float* hpR,
+                         float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                         int numSamples, const ProLogicGains& gains) noexcept;
+
+    //==============================================================================
+    /** Abschluss-Mix: Bass zurück in L/R, Mono-Bass ins LFE, Rest aus tmpOut übernehmen. */
+    void outputMix (const float* lpL, const float* lpR,
+                    const float* tL, const float* tR, const float* tC, const float* tLs, const float* tRs,
+                    float* outL, float* outR, float* outC, float* outLFE, float* outLs, float* outRs,
+                    int numSamples, GainRamp lfeGain) noexcept;
+
+    //==============================================================================
+    struct Neo6Gains
+    {
+        GainRamp surroundGain;
+        GainRamp centerWidth;
+    };
+
+    /** Zulässige Steuerraten für neo6BandControlRate (Samples pro Stützstelle). */
+    enum Neo6SteeringInterval
+    {
+        neo6SteerPerSample = 1,
+        neo6SteerEvery16   = 16,
+        neo6SteerEvery32   = 32
+    };
+
+    /** Maximale Abweichung der Steuergrößen (cGain/lrGain/sGain) gegenüber der
+        Per-Sample-Variante. An den Stützstellen ist der Zustand exakt; dazwischen
+        ändert sich der Glätter um höchstens (1 - alpha) * 2 pro Sample, die Rampe
+        liegt also im ungünstigsten Fall interval * 5e-4 daneben (16 -> 0.008,
+        32 -> 0.016). Mit Musik/Rauschen gemessen: 1.4e-3 (16) bzw. 2.7e-3 (32),
+        bezogen auf den Eingangspegel.
+    */
+    constexpr float neo6ControlRateTolerance (Neo6SteeringInterval interval) noexcept
+    {
+        return interval == neo6SteerPerSample ? 0.0f : (float) interval * 5.0e-4f;
+    }
+
+    /** Neo:6-Band mit Steuerung auf Control-Rate.
+
+        Der Steuerzustand wird nur alle 'interval' Samples aktualisiert - dann aber
+        exakt: Die Per-Sample-Zielwerte werden vektorisiert berechnet und mit den
+        Gewichten des Einpol-Glätters (alpha^k) aufsummiert. Dazwischen laufen
+        die C/LR/S-Gains als lineare Rampe. Das Ergebnis wird auf die Ausgänge
+        addiert (wie bei processNeo6Band).
+    */
+    void neo6BandControlRate (const float* inL, const float* inR,
+                              float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                              int numSamples, const Neo6Gains& gains,
+                              Neo6SteeringInterval interval, float& steerState) noexcept;
+
+    //==============================================================================
+    /** Hüllkurven des Modern-Transient-Modus (schnell/langsam je Kanal). */
+    struct TransientState
+    {
+        float fastEnvL = 0.0f;
+        float slowEnvL = 0.0f;
+        float fastEnvR = 0.0f;
+        float slowEnvR = 0.0f;
+    };
+
+    struct TransientGains
+    {
+        GainRamp centerGain;
+        GainRamp frontWeight;
+        GainRamp surroundBalance;
+        GainRamp dialogExtract;
+    };
+
+    /** Modern Transient: L und R laufen als zwei Lanes eines SIMD-Registers,
+        die Hüllkurven-Entscheidungen sind verzweigungsfrei (compare + select).
+        Der Dialog-Anteil wird vor der Schleife entschieden. Bit-identisch zur
+        skalaren Referenz, solange der Compiler keine FMAs einsetzt.
+    */
+    void transientMatrix (const float* hpL, const float* hpR,
+                          float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                          int numSamples, const TransientGains& gains, TransientState& state) noexcept;
+
+    //==============================================================================
+    /** Zustand und Gains des STFT-Modus für einen Frame. */
+    struct SpectralGains
+    {
+        float smoothing;       // Einpol-Glättung der Statistik pro Frame (alpha)
+        float surroundGain;    // Ambience → Ls/Rs
+        float frontAmbience;   // Ambience, die vorne bleibt (L/R)
+        float dialogExtract;   // 0 = nur klar mittige Bins in den Center, 1 = breit
+    };
+
+    /** STFT-Upmix, ein Frame, Split-Format (Real- und Imaginärteil getrennt), numBins Bins.
+
+        Glättet pro Bin |L|², |R|² und L·R* über die Zeit und leitet daraus ab:
+          direkt   = max(Kohärenz, |Panning|)    (panierte Einzelquellen zählen als direkt)
+          Ambience = sqrt(1 - direkt²)
+          Center   = Ähnlichkeit 2|L·R*| / (|L|² + |R|²), durch dialogExtract geformt
+        und schreibt vier reelle Gewichte pro Bin:
+          L' = directGain · L + crossGain · R      R' = crossGain · L + directGain · R
+          C  = centerGain · (L + R)                Ls = ambienceGain · L,  Rs = ambienceGain · R
+    */
+    void spectralWeights (const float* lRe, const float* lIm, const float* rRe, const float* rIm,
+                          float* powerL, float* powerR, float* crossRe, float* crossIm,
+                          float* directGain, float* crossGain, float* centerGain, float* ambienceGain,
+                          int numBins, const SpectralGains& gains) noexcept;
+
+    //==============================================================================
+    /** Latenzfreier PCA-Upmix: Zustand der Filterbank für L und R.
+
+        Band k ist die Differenz zweier Butterworth-Tiefpässe (TP_k - TP_k-1),
+        das oberste Band ist x - TP_K-2. Die Summe aller Bänder ergibt damit
+        exakt den Eingang - ohne Latenz und ohne Phasenkorrektur. Jedes Band
+        ist eine SIMD-Lane; pro Band laufen die 2x2-Kovarianz und eine
+        5x2-Ausgangsmatrix, die alle pcaControlInterval Samples neu bestimmt
+        und dazwischen linear gerampt wird.
+    */
+    struct PcaState
+    {
+        static constexpr int maxBands = 16;
+
+        int numBands = 8;
+        int samplesUntilUpdate = 0;
+        float covarianceSmoothing = 0.0f;   // Einpol-Koeffizient pro Sample
+
+        // TDF-II-Koeffizienten der Tiefpässe, eine Lane pro Band (die letzte ist Identität)
+        alignas (64) float b0[maxBands] {}, b1[maxBands] {}, b2[maxBands] {}, a1[maxBands] {}, a2[maxBands] {};
+        alignas (64) float s1L[maxBands] {}, s2L[maxBands] {}, s1R[maxBands] {}, s2R[maxBands] {};
+
+        // Geglättete Kovarianz pro Band
+        alignas (64) float covLL[maxBands] {}, covRR[maxBands] {}, covLR[maxBands] {};
+
+        // Ausgangsmatrix (L, R, C, Ls, Rs jeweils aus Band-L und Band-R) und Rampe
+        static constexpr int numMix = 10;
+        alignas (64) float mix[numMix][maxBands] {};
+        alignas (64) float mixStep[numMix][maxBands] {};
+    };
+
+    /** Samples zwischen zwei Neuberechnungen der PCA-Matrix. */
+    constexpr int pcaControlInterval = 32;
+
+    /** Filterbank für numBands (8 oder 16) Bänder auslegen, Zustand löschen. Allokiert nicht. */
+    void preparePcaFilterbank (PcaState& state, double sampleRate, int numBands) noexcept;
+
+    struct PcaGains
+    {
+        GainRamp surroundGain;    // Ambience → Ls/Rs, der Rest bleibt vorne
+        GainRamp dialogExtract;   // 0 = nur klar mittige Bänder in den Center, 1 = breit
+    };
+
+    /** PCA-Upmix: pro Band Hauptkomponente (direkt) nach L/C/R, Residuum
+        (Ambience) nach Ls/Rs. Überschreibt die fünf Ausgänge. Gains werden an
+        den Stützstellen ausgewertet.
+    */
+    void pcaUpmix (const float* hpL, const float* hpR,
+                   float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                   int numSamples, const PcaGains& gains, PcaState& state) noexcept;
+
+    //==============================================================================
+    /** Eine Biquad-Stufe in Trapez-SVF-Form (Simper), Default = Identität:
+          v3 = x - s2,  v1 = a1 s1 + a2 v3,  v2 = s2 + a2 s1 + a3 v3
+          s1 = 2 v1 - s1,  s2 = 2 v2 - s2,  y = m0 x + m1 v1 + m2 v2
+
+        Übertragungsfunktion wie ein bilinear transformierter Biquad, aber die
+        Zustände bleiben auch bei tiefen Grenzfrequenzen in float gut konditioniert.
+        Transponierte Direktform II verliert dort die Stellen (a1 ~ -2, a2 ~ 1):
+        LR4 bei 40 Hz / 192 kHz lag mit TDF-II bis 4e-4 neben dem exakten
+        Ergebnis, in dieser Form bei 2e-7 - wie der Linkwitz-Riley-Filter von JUCE.
+    */
+    struct BiquadCoefficients
+    {
+        float a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+        float m0 = 1.0f, m1 = 0.0f, m2 = 0.0f;
+    };
+
+    /** Butterworth (Q = 1/√2), bilinear mit Vorverzerrung bei frequency. Zwei gleiche
+        Stufen in Serie ergeben den Linkwitz-Riley-Filter 4. Ordnung von JUCE.
+    */
+    BiquadCoefficients makeButterworthLowPass  (double sampleRate, double frequency) noexcept;
+    BiquadCoefficients makeButterworthHighPass (double sampleRate, double frequency) noexcept;
+
+    /** Bandpass mit 0 dB im Maximum (wie juce::dsp::IIR::Coefficients::makeBandPass). */
+    BiquadCoefficients makeBandPass (double sampleRate, double frequency, double q) noexcept;
+
+    /** Mehrkanalige Filterbank: jede Lane ist ein eigener Filterzug (z.B. Kanal x
+        Tiefpass/Hochpass) aus bis zu maxStages Biquads in Serie. Koeffizienten und
+        Zustände liegen lane-weise, so dass eine Stufe für alle Lanes ein einziger
+        SIMD-Schritt ist.
+    */
+    struct BiquadBank
+    {
+        static constexpr int maxLanes  = 8;
+        static constexpr int maxStages = 2;
+
+        int numLanes  = 0;
+        int numStages = 0;
+
+        alignas (64) float a1[maxStages][maxLanes] {}, a2[maxStages][maxLanes] {}, a3[maxStages][maxLanes] {};
+        alignas (64) float m0[maxStages][maxLanes] {}, m1[maxStages][maxLanes] {}, m2[maxStages][maxLanes] {};
+        alignas (64) float s1[maxStages][maxLanes] {}, s2[maxStages][maxLanes] {};
+    };
+
+    /** Lanes und Stufen festlegen: alle Stufen Identität, Zustand gelöscht. Allokiert nicht. */
+    void prepareBiquadBank (BiquadBank& bank, int numLanes, int numStages) noexcept;
+
+    /** Koeffizienten einer Stufe setzen; der Zustand bleibt (wie bei setCutoffFrequency). */
+    void setBiquadStage (BiquadBank& bank, int lane, int stage, const BiquadCoefficients& c) noexcept;
+
+    void resetBiquadBank (BiquadBank& bank) noexcept;
+
+    /** Lane k liest inputs[k] und schreibt outputs[k]. Ein- und Ausgänge dürfen
+        sich beliebig überlappen (in-place, mehrere Lanes auf demselben Eingang):
+        pro Abschnitt werden erst alle Lanes gelesen, dann geschrieben.
+    */
+    void biquadBank (const float* const* inputs, float* const* outputs, int numSamples, BiquadBank& bank) noexcept;
+
+    /** Band-Splitter-Baum aus zwei Bänken in einem Durchlauf: Lane k des Stamms liest
+        inputs[k], Lane k des Asts liest den Stammausgang trunkTaps[k]. Stammausgänge
+        gehen nach trunkOutputs[k] - nullptr heißt reines Zwischenergebnis, das nur im
+        Abschnitt auf dem Stack existiert -, Astausgänge nach branchOutputs[k].
+
+        Beispiel Crossover + Neo:6: Stamm {LP L, LP R, HP L, HP R}, Ast {LP 3k, HP 3k}
+        auf den Taps {2, 3, 2, 3}; der Hochpass wird nie in einen Puffer geschrieben.
+    */
+    void biquadBankTree (const float* const* inputs, float* const* trunkOutputs, BiquadBank& trunk,
+                         const int* trunkTaps, float* const* branchOutputs, BiquadBank& branch,
+                         int numSamples) noexcept;
+
+    //==============================================================================
+    /** Schroeder-Allpass (kanonische Form, eine Verzögerung der Länge M):
+          w[n] = x[n] + g * w[n - M],   y[n] = -g * w[n] + w[n - M]
+
+        In-place auf data; ring hält w der letzten M Samples und wird Slot für
+        Slot überschrieben. numSamples darf höchstens bis zum Ringende reichen
+        (der Aufrufer teilt an der Wrap-Grenze). Weil die Rückkopplung M >=
+        SIMD-Breite Samples zurückgreift, ist der Kernel über die Zeit
+        vektorisiert - keine Abhängigkeit innerhalb eines Registers.
+    */
+    void schroederAllpass (float* data, float* ring, int numSamples, float gain) noexcept;
+
+    //==============================================================================
+    /** Gelinkte Spitzenwerte für den Limiter: peak[i] = max(peak[i], |data[i]|). */
+    void accumulatePeak (const float* data, float* peak, int numSamples) noexcept;
+
+    /** Taps pro Phase des True-Peak-Interpolators (4x polyphas, gefensterter Sinc). */
+    constexpr int truePeakTaps = 16;
+
+    /** Wie accumulatePeak, aber mit den drei Zwischenwerten (1/4, 1/2, 3/4) der 4x-
+        Überabtastung. history zeigt auf truePeakTaps - 1 ältere Samples, gefolgt
+        von numSamples neuen. Ergebnis i bezieht sich auf Sample i - truePeakTaps / 2
+        (Gruppenlaufzeit des Interpolators); accumulatePeak muss dann mit derselben
+        Verzögerung aufgerufen werden.
+    */
+    void accumulateTruePeak (const float* history, float* peak, int numSamples) noexcept;
+
+    /** Berechnet die Interpolator-Koeffizienten für accumulateTruePeak. Einmal vor dem
+        ersten Audio-Block aufrufen (LookaheadLimiter::prepare), sonst entsteht die
+        Tabelle beim ersten True-Peak-Block auf dem Audio-Thread.
+    */
+    void prepareTruePeak() noexcept;
+
+    //==============================================================================
+    /** Meter: Quadratsumme und Betragsspitze eines Kanals in einem einzigen Durchlauf.
+        Die Ergebnisse werden auf sumOfSquares bzw. peak aufaddiert / maximiert.
+    */
+    void measureLevel (const float* data, int numSamples, double& sumOfSquares, float& peak) noexcept;
+
+    /** Quadratsummen und Spitzen mehrerer Kanäle (Meter), für Stufen, die beim Schreiben
+        selbst messen. numChannels = 0: nichts messen.
+    */
+    struct LevelAccumulators
+    {
+        double* sumOfSquares = nullptr;
+        float* peaks = nullptr;
+        int numChannels = 0;
+    };
+
+    /** Limiter-Ausgang in einem Durchlauf: data und ring tauschen die Inhalte (Verzögerung
+        um die Ringlänge), der verzögerte Wert wird mit gain multipliziert (nullptr = 1) und
+        wie bei measureLevel auf sumOfSquares/peak gemessen (nullptr = kein Meter).
+    */
+    void delayApplyGain (float* data, float* ring, const float* gain, int numSamples,
+                         double* sumOfSquares, float* peak) noexcept;
+
+    //==============================================================================
+    /** Die ursprünglichen skalaren Schleifen - Referenz für Benchmarks und Genauigkeit.
+        Mit konstanten Gains exakt die alten Schleifen; Rampen werden pro Sample
+        ausgewertet, daher dienen sie auch als Rest-Pfad der SIMD-Kernels.
+    */
+    namespace reference
+    {
+        void coherentMatrix (const float* hpL, const float* hpR, const float* dialog,
+                             float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                             int numSamples, const CoherentGains& gains) noexcept;
+
+        void proLogicMatrix (const float* hpL, const float* hpR,
+                             float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                             int numSamples, const ProLogicGains& gains) noexcept;
+
+        void outputMix (const float* lpL, const float* lpR,
+                        const float* tL, const float* tR, const float* tC, const float* tLs, const float* tRs,
+                        float* outL, float* outR, float* outC, float* outLFE, float* outLs, float* outRs,
+                        int numSamples, GainRamp lfeGain) noexcept;
+
+        /** Neo:6-Band mit Glättung und Division pro Sample (alpha = 0.9995). */
+        void neo6Band (const float* inL, const float* inR,
+                       float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                       int numSamples, const Neo6Gains& gains, float& steerState) noexcept;
+
+        /** Modern Transient mit vier verzweigten Hüllkurvenfolgern. */
+        void transientMatrix (const float* hpL, const float* hpR,
+                              float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                              int numSamples, const TransientGains& gains, TransientState& state) noexcept;
+
+        void spectralWeights (const float* lRe, const float* lIm, const float* rRe, const float* rIm,
+                              float* powerL, float* powerR, float* crossRe, float* crossIm,
+                              float* directGain, float* crossGain, float* centerGain, float* ambienceGain,
+                              int numBins, const SpectralGains& gains) noexcept;
+
+        /** PCA-Upmix Band für Band, eine skalare Schleife pro Lane. */
+        void pcaUpmix (const float* hpL, const float* hpR,
+                       float* outL, float* outR, float* outC, float* outLs, float* outRs,
+                       int numSamples, const PcaGains& gains, PcaState& state) noexcept;
+
+        /** Lane für Lane, Sample für Sample - dieselbe Rechenreihenfolge wie die SIMD-Variante. */
+        void biquadBank (const float* const* inputs, float* const* outputs, int numSamples, BiquadBank& bank) noexcept;
+
+        void biquadBankTree (const float* const* inputs, float* const* trunkOutputs, BiquadBank& trunk,
+                             const int* trunkTaps, float* const* branchOutputs, BiquadBank& branch,
+                             int numSamples) noexcept;
+
+        void schroederAllpass (float* data, float* ring, int numSamples, float gain) noexcept;
+
+        void accumulatePeak (const float* data, float* peak, int numSamples) noexcept;
+        void accumulateTruePeak (const float* history, float* peak, int numSamples) noexcept;
+
+        void measureLevel (const float* data, int numSamples, double& sumOfSquares, float& peak) noexcept;
+
+        void delayApplyGain (float* data, float* ring, const float* gain, int numSamples,
+                             double* sumOfSquares, float* peak) noexcept;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+==============================================================================
+    UpmixParameters.h
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "UpmixEngine.h"
+
+//==============================================================================
+/** Alle Parameterwerte für einen Block (die Struktur gehört der Engine). */
+using ParameterSnapshot = UpmixEngine::Parameters;
+
+//==============================================================================
+/**
+    Zwischengespeicherte Zeiger auf die Rohwerte der APVTS.
+
+    Die String-Lookups passieren genau einmal im Konstruktor; auf dem
+    Audio-Thread bleiben nur noch atomare Loads.
+*/
+class ParameterHandles
+{
+public:
+    explicit ParameterHandles (juce::AudioProcessorValueTreeState& apvts)
+        : surroundBalance (get (apvts, "surroundBalance")),
+          lfeAmount       (get (apvts, "lfeAmount")),
+          crossoverFreq   (get (apvts, "crossoverFreq")),
+          dialogExtract   (get (apvts, "dialogExtract")),
+          centerComp      (get (apvts, "centerComp")),
+          surroundDelay   (get (apvts, "surroundDelay")),
+          processingMode  (get (apvts, "processingMode")),
+          loudnessBoost   (get (apvts, "loudnessBoost")),
+          neo6Steering    (get (apvts, "neo6Steering")),
+          spectralFftSize (get (apvts, "spectralFftSize")),
+          spectralOverlap (get (apvts, "spectralOverlap")),
+          pcaBands        (get (apvts, "pcaBands")),
+          surroundDecorrelation (get (apvts, "surroundDecorrelation")),
+          limiterTruePeak (get (apvts, "limiterTruePeak"))
+    {
+    }
+
+    ParameterSnapshot load() const noexcept
+    {
+        ParameterSnapshot p;
+        p.surroundBalance = surroundBalance->load (std::memory_order_relaxed);
+        p.lfeAmountDb     = lfeAmount->load (std::memory_order_relaxed);
+        p.crossoverHz     = crossoverFreq->load (std::memory_order_relaxed);
+        p.dialogExtract   = dialogExtract->load (std::memory_order_relaxed);
+        p.centerComp      = centerComp->load (std::memory_order_relaxed);
+        p.surroundDelayMs = surroundDelay->load (std::memory_order_relaxed);
+        p.processingMode  = (int) processingMode->load (std::memory_order_relaxed);
+        p.loudnessBoost   = loudnessBoost->load (std::memory_order_relaxed) > 0.5f;
+        p.neo6Steering    = (int) neo6Steering->load (std::memory_order_relaxed);
+        p.spectralFftSize = (int) spectralFftSize->load (std::memory_order_relaxed);
+        p.spectralOverlap = (int) spectralOverlap->load (std::memory_order_relaxed);
+        p.pcaBands        = (int) pcaBands->load (std::memory_order_relaxed);
+        p.surroundDecorrelation = surroundDecorrelation->load (std::memory_order_relaxed) > 0.5f;
+        p.limiterTruePeak = limiterTruePeak->load (std::memory_order_relaxed) > 0.5f;
+        return p;
+    }
+
+private:
+    static std::atomic<float>* get (juce::AudioProcessorValueTreeState& apvts, const char* id)
+    {
+        auto* value = apvts.getRawParameterValue (id);
+        jassert (value != nullptr); // Parameter-ID vertippt?
+        return value;
+    }
+
+    std::atomic<float>* surroundBalance;
+    std::atomic<float>* lfeAmount;
+    std::atomic<float>* crossoverFreq;
+    std::atomic<float>* dialogExtract;
+    std::atomic<float>* centerComp;
+    std::atomic<float>* surroundDelay;
+    std::atomic<float>* processingMode;
+    std::atomic<float>* loudnessBoost;
+    std::atomic<float>* neo6Steering;
+    std::atomic<float>* spectralFftSize;
+    std::atomic<float>* spectralOverlap;
+    std::atomic<float>* pcaBands;
+    std::atomic<float>* surroundDecorrelation;
+    std::atomic<float>* limiterTruePeak;
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterHandles)
+};
@@ -0,0 +1,306 @@
+/*
+==============================================================================
+    BatchRender.cpp
+==============================================================================
+*/
+
+#include "BatchRender.h"
+
+#include <deque>
+#include <iostream>
+#include <mutex>
+
+namespace
+{
+    double now() noexcept { return juce::Time::getMillisecondCounterHiRes() * 0.001; }
+
+    //==============================================================================
+    /**
+        Eine Deque pro Worker. Die Jobs werden reihum verteilt - jeder Worker
+        startet also mit einer der längsten Dateien. Ist die eigene Deque leer,
+        stiehlt der Worker den längsten noch wartenden Job eines anderen.
+        Die Granularität ist eine ganze Datei, ein Mutex pro Deque genügt.
+    */
+    class WorkStealingQueue
+    {
+    public:
+        WorkStealingQueue (int numWorkers, const juce::Array<BatchRender::Job>& jobsLongestFirst)
+            : jobs (jobsLongestFirst), queues ((size_t) numWorkers)
+        {
+            for (int i = 0; i < jobs.size(); ++i)
+                queues[(size_t) (i % numWorkers)].indices.push_back (i);
+        }
+
+        /** -1, wenn nirgends mehr Arbeit liegt. */
+        int pop (int worker)
+        {
+            {
+                auto& own = queues[(size_t) worker];
+                const std::lock_guard<std::mutex> lock (own.mutex);
+
+                if (! own.indices.empty())
+                {
+                    const int index = own.indices.front();
+                    own.indices.pop_front();
+                    return index;
+                }
+            }
+
+            return steal (worker);
+        }
+
+        const BatchRender::Job& getJob (int index) const { return jobs.getReference (index); }
+
+    private:
+        int steal (int thief)
+        {
+            for (;;)
+            {
+                // Opfer mit dem längsten wartenden Job suchen
+                int victim = -1;
+                double longest = -1.0;
+
+                for (size_t q = 0; q < queues.size(); ++q)
+                {
+                    if ((int) q == thief)
+                        continue;
+
+                    const std::lock_guard<std::mutex> lock (queues[q].mutex);
+
+                    if (! queues[q].indices.empty())
+                    {
+                        const double duration = jobs.getReference (queues[q].indices.front()).durationSeconds;
+
+                        if (duration > longest)
+                        {
+                            longest = duration;
+                            victim  = (int) q;
+                        }
+                    }
+                }
+
+                if (victim < 0)
+                    return -1;
+
+                auto& q = queues[(size_t) victim];
+                const std::lock_guard<std::mutex> lock (q.mutex);
+
+                // Kann inzwischen leer sein - dann neu suchen
+                if (! q.indices.empty())
+                {
+                    const int index = q.indices.front();
+                    q.indices.pop_front();
+                    return index;
+                }
+            }
+        }
+
+        struct Deque
+        {
+            std::mutex mutex;
+            std::deque<int> indices;
+        };
+
+        const juce::Array<BatchRender::Job>& jobs;
+        std::vector<Deque> queues;
+    };
+
+    //==============================================================================
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker (int workerIndex, WorkStealingQueue& q, const BatchRender::Settings& s,
+                juce::CriticalSection& outputLock, BatchRender::Summary& summaryToUpdate)
+            : juce::Thread ("Upmix Worker " + juce::String (workerIndex)),
+              index (workerIndex), queue (q), settings (s),
+              printLock (outputLock), summary (summaryToUpdate)
+        {
+            formats.registerBasicFormats();
+        }
+
+        ~Worker() override
+        {
+            stopThread (-1);
+        }
+
+        CoherentUpmixAudioProcessor& getProcessor() noexcept { return processor; }
+
+        void run() override
+        {
+            readThread.startThread();
+            writeThread.startThread();
+
+            for (int job = queue.pop (index); job >= 0 && ! threadShouldExit(); job = queue.pop (index))
+                renderJob (queue.getJob (job));
+
+            readThread.stopThread (-1);
+            writeThread.stopThread (-1);
+        }
+
+    private:
+        void renderJob (const BatchRender::Job& job)
+        {
+            OfflineRender::Stats stats;
+            const auto result = render (job, stats);
+
+            const juce::ScopedLock sl (printLock);
+
+            if (result.failed())
+            {
+                ++summary.numFailed;
+                std::cerr << job.input.getFileName() << ": " << result.getErrorMessage() << std::endl;
+                return;
+            }
+
+            ++summary.numFiles;
+            summary.audioSeconds += stats.getAudioSeconds();
+            std::cout << "[" << index << "] " << job.input.getFileName() << ": "
+                      << OfflineRender::describe (stats) << std::endl;
+        }
+
+        juce::Result render (const BatchRender::Job& job, OfflineRender::Stats& stats)
+        {
+            std::unique_ptr<juce::AudioFormatReader> source (formats.createReaderFor (job.input));
+
+            if (source == nullptr)
+                return juce::Result::fail ("Kann nicht gelesen werden");
+
+            juce::String error;
+            auto writer = OfflineRender::createWriter (formats, job.output, source->sampleRate,
+                                                       OfflineRender::getOutputChannelSet (settings.render),
+                                                       settings.render.bitsPerSample, error);
+            if (writer == nullptr)
+                return juce::Result::fail (error);
+
+            const double startTime = now();
+
+            // Read-Ahead: der Reader-Thread füllt den Puffer, process() wartet nur, falls er zurückliegt
+            const int blockSize = settings.render.blockSize;
+            juce::BufferingAudioReader reader (source.release(), readThread,
+                                               juce::jmax (settings.readAheadSamples, 4 * blockSize));
+            reader.setReadTimeout (-1);
+
+            auto result = juce::Result::ok();
+
+            {
+                // Write-Behind: ThreadedWriter übernimmt den Writer und schreibt auf writeThread
+                // Der FIFO muss mindestens einen ganzen Block fassen, sonst wartet write() ewig
+                juce::AudioFormatWriter::ThreadedWriter threadedWriter (writer.release(), writeThread,
+                                                                        juce::jmax (settings.writeBehindSamples, 4 * blockSize));
+
+                result = OfflineRender::process (processor, reader,
+                                                 [&threadedWriter, this] (const float* const* channels, int numSamples)
+                                                 {
+                                                     // FIFO voll → kurz warten, bis der Schreib-Thread aufholt
+                                                     while (! threadedWriter.write (channels, numSamples))
+                                                     {
+                                                         if (threadShouldExit())
+                                                             return false;
+
+                                                         juce::Thread::sleep (1);
+                                                     }
+
+                                                     return true;
+                                                 },
+                                                 settings.render, stats);
+            } // Destruktor leert den FIFO und schließt die Datei
+
+            stats.wallSeconds = now() - startTime;
+            return result;
+        }
+
+        const int index;
+        WorkStealingQueue& queue;
+        const BatchRender::Settings& settings;
+        juce::CriticalSection& printLock;
+        BatchRender::Summary& summary;
+
+        CoherentUpmixAudioProcessor processor;
+        juce::AudioFormatManager formats;
+        juce::TimeSliceThread readThread  { "Upmix Read-Ahead" };
+        juce::TimeSliceThread writeThread { "Upmix Write-Behind" };
+    };
+
+    bool isAudioFile (juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        return formats.findFormatForFileExtension (file.getFileExtension()) != nullptr;
+    }
+}
+
+//==============================================================================
+juce::Array<BatchRender::Job> BatchRender::createJobs (juce::AudioFormatManager& formats, const juce::StringArray& inputs,
+                                                       const juce::File& outputDirectory, const juce::String& outputExtension,
+                                                       juce::StringArray& errors)
+{
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    juce::Array<juce::File> files;
+
+    for (const auto& input : inputs)
+    {
+        const auto file = cwd.getChildFile (input);
+
+        if (file.isDirectory())
+        {
+            for (const auto& entry : juce::RangedDirectoryIterator (file, true, "*", juce::File::findFiles))
+                if (isAudioFile (formats, entry.getFile()))
+                    files.add (entry.getFile());
+        }
+        else
+        {
+            files.add (file);
+        }
+    }
+
+    juce::Array<Job> jobs;
+
+    for (const auto& file : files)
+    {
+        // Nur den Header lesen, um die Länge zu kennen
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (file));
+
+        if (reader == nullptr || reader->sampleRate <= 0.0)
+        {
+            errors.add (file.getFullPathName() + ": kann nicht gelesen werden");
+            continue;
+        }
+
+        Job job;
+        job.input  = file;
+        job.output = outputDirectory.getChildFile (file.getFileNameWithoutExtension() + outputExtension);
+        job.durationSeconds = (double) reader->lengthInSamples / reader->sampleRate;
+        jobs.add (job);
+    }
+
+    std::stable_sort (jobs.begin(), jobs.end(),
+                      [] (const Job& a, const Job& b) { return a.durationSeconds > b.durationSeconds; });
+    return jobs;
+}
+
+BatchRender::Summary BatchRender::run (const juce::Array<Job>& jobs, const Settings& settings,
+                                       const std::function<void (CoherentUpmixAudioProcessor&)>& configureProcessor)
+{
+    const int numWorkers = juce::jlimit (1, juce::jmax (1, jobs.size()), settings.numWorkers);
+
+    WorkStealingQueue queue (numWorkers, jobs);
+    juce::CriticalSection printLock;
+    Summary summary;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back (std::make_unique<Worker> (i, queue, settings, printLock, summary));
+        configureProcessor (workers.back()->getProcessor());
+    }
+
+    const double startTime = now();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit (-1);
+
+    summary.wallSeconds = now() - startTime;
+    return summary;
+}
@@ -0,0 +1,55 @@
+/*
+==============================================================================
+    BatchRender.h
+
+    Batch-Modus für UpmixRender: ein Worker-Thread pro Kern, jeder mit eigenem
+    CoherentUpmixAudioProcessor. Die Dateien liegen in einer Work-Stealing-
+    Queue, längste zuerst, damit lange Dateien nicht am Ende übrig bleiben.
+    Lesen und Schreiben laufen pro Worker auf eigenen I/O-Threads
+    (Read-Ahead / Write-Behind), der Worker rechnet nur.
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OfflineRender.h"
+
+namespace BatchRender
+{
+    struct Job
+    {
+        juce::File input, output;
+        double durationSeconds = 0.0;
+    };
+
+    struct Settings
+    {
+        OfflineRender::Settings render;
+        int numWorkers         = juce::SystemStats::getNumCpus();
+        int readAheadSamples   = 1 << 18;
+        int writeBehindSamples = 1 << 18;
+    };
+
+    struct Summary
+    {
+        int numFiles  = 0;
+        int numFailed = 0;
+        double audioSeconds = 0.0;
+        double wallSeconds  = 0.0;
+
+        double getAudioHoursPerMinute() const noexcept
+        {
+            return wallSeconds > 0.0 ? (audioSeconds / 3600.0) / (wallSeconds / 60.0) : 0.0;
+        }
+    };
+
+    /** Dateien und Ordner (rekursiv) → Jobs, nach Länge absteigend sortiert. */
+    juce::Array<Job> createJobs (juce::AudioFormatManager& formats, const juce::StringArray& inputs,
+                                 const juce::File& outputDirectory, const juce::String& outputExtension,
+                                 juce::StringArray& errors);
+
+    /** configureProcessor wird einmal pro Worker-Prozessor aufgerufen (Parameter setzen). */
+    Summary run (const juce::Array<Job>& jobs, const Settings& settings,
+                 const std::function<void (CoherentUpmixAudioProcessor&)>& configureProcessor);
+}
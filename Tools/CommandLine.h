@@ -0,0 +1,73 @@
+/*
+==============================================================================
+    CommandLine.h
+
+    Minimaler Parser für die Offline-Tools: "--name wert", "--name=wert",
+    Schalter ohne Wert und Positionsargumente.
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class CommandLine
+{
+public:
+    /** switches: Optionen ohne Wert (z.B. "help"), ohne führende Striche. */
+    CommandLine (int argc, char* argv[], const juce::StringArray& switches)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const juce::String arg (juce::CharPointer_UTF8 (argv[i]));
+
+            if (! arg.startsWith ("--"))
+            {
+                positional.add (arg);
+                continue;
+            }
+
+            auto name = arg.substring (2);
+
+            if (name.contains ("="))
+            {
+                options.set (name.upToFirstOccurrenceOf ("=", false, false),
+                             name.fromFirstOccurrenceOf ("=", false, false));
+            }
+            else if (switches.contains (name))
+            {
+                options.set (name, "1");
+            }
+            else if (i + 1 < argc)
+            {
+                // Wert ist immer das nächste Argument - auch wenn es mit '-' beginnt (z.B. --lfeAmount -12)
+                options.set (name, juce::String (juce::CharPointer_UTF8 (argv[++i])));
+            }
+            else
+            {
+                error = "Option --" + name + " erwartet einen Wert";
+            }
+        }
+    }
+
+    bool has (const juce::String& name) const                       { return options.containsKey (name); }
+    juce::String get (const juce::String& name, const juce::String& fallback = {}) const
+    {
+        return has (name) ? options[name] : fallback;
+    }
+
+    int getInt (const juce::String& name, int fallback) const
+    {
+        return has (name) ? options[name].getIntValue() : fallback;
+    }
+
+    const juce::StringPairArray& getOptions() const noexcept        { return options; }
+    const juce::StringArray& getPositional() const noexcept         { return positional; }
+    const juce::String& getError() const noexcept                   { return error; }
+
+private:
+    juce::StringPairArray options { false };
+    juce::StringArray positional;
+    juce::String error;
+};
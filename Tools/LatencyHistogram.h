@@ -0,0 +1,97 @@
+/*
+==============================================================================
+    LatencyHistogram.h
+
+    Log-lineares Histogramm für Laufzeiten (ähnlich HdrHistogram): Werte
+    unter 128 werden exakt gezählt, darüber hat jede Zweierpotenz 64
+    Unterteilungen - die relative Auflösung ist also besser als 1.6 %.
+    Feste Größe, record() allokiert nicht. Maximum und Minimum sind exakt.
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() : counts ((size_t) numBuckets, 0) {}
+
+    void record (juce::uint64 value) noexcept
+    {
+        ++counts[(size_t) getBucket (value)];
+        ++total;
+        maximum = juce::jmax (maximum, value);
+        minimum = juce::jmin (minimum, value);
+    }
+
+    juce::uint64 getCount() const noexcept      { return total; }
+    juce::uint64 getMax() const noexcept        { return maximum; }
+    juce::uint64 getMin() const noexcept        { return total > 0 ? minimum : 0; }
+
+    /** Obergrenze des Buckets, in dem das Perzentil liegt (nie über dem Maximum). */
+    juce::uint64 getPercentile (double percent) const noexcept
+    {
+        if (total == 0)
+            return 0;
+
+        const auto target = (juce::uint64) juce::jmax (1.0, std::ceil (percent / 100.0 * (double) total));
+        juce::uint64 seen = 0;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            seen += counts[(size_t) i];
+
+            if (seen >= target)
+                return juce::jmin (maximum, getBucketUpperBound (i));
+        }
+
+        return maximum;
+    }
+
+private:
+    static constexpr int linearBits = 7;                      // 0..127 exakt
+    static constexpr int subBuckets = 1 << (linearBits - 1);  // 64 pro Oktave
+    static constexpr int maxBits    = 48;                     // bis ~2.8e14 (ns: ~78 h)
+    static constexpr int numBuckets = (1 << linearBits) + (maxBits - linearBits) * subBuckets;
+
+    static int highestBit (juce::uint64 value) noexcept
+    {
+        int bit = 0;
+
+        while ((value >> (bit + 1)) != 0)
+            ++bit;
+
+        return bit;
+    }
+
+    static int getBucket (juce::uint64 value) noexcept
+    {
+        if (value < (1u << linearBits))
+            return (int) value;
+
+        const int shift = juce::jmin (highestBit (value), maxBits - 1) - (linearBits - 1);
+        const auto mantissa = juce::jmin ((juce::uint64) (2 * subBuckets - 1), value >> shift);
+
+        return (1 << linearBits) + (shift - 1) * subBuckets + (int) (mantissa - subBuckets);
+    }
+
+    static juce::uint64 getBucketUpperBound (int bucket) noexcept
+    {
+        if (bucket < (1 << linearBits))
+            return (juce::uint64) bucket;
+
+        const int offset   = bucket - (1 << linearBits);
+        const int shift    = offset / subBuckets + 1;
+        const auto mantissa = (juce::uint64) (offset % subBuckets + subBuckets);
+
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    std::vector<juce::uint64> counts;
+    juce::uint64 total   = 0;
+    juce::uint64 maximum = 0;
+    juce::uint64 minimum = std::numeric_limits<juce::uint64>::max();
+};
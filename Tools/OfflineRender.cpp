@@ -0,0 +1,187 @@
+/*
+==============================================================================
+    OfflineRender.cpp
+==============================================================================
+*/
+
+#include "OfflineRender.h"
+
+namespace
+{
+    double now() noexcept { return juce::Time::getMillisecondCounterHiRes() * 0.001; }
+
+    juce::String formatDuration (double seconds)
+    {
+        const auto total = (juce::int64) seconds;
+        return juce::String (total / 3600) + ":"
+             + juce::String ((total / 60) % 60).paddedLeft ('0', 2) + ":"
+             + juce::String (total % 60).paddedLeft ('0', 2);
+    }
+}
+
+std::unique_ptr<juce::AudioFormatWriter> OfflineRender::createWriter (juce::AudioFormatManager& formats,
+                                                                      const juce::File& file, double sampleRate,
+                                                                      const juce::AudioChannelSet& channels,
+                                                                      int bitsPerSample, juce::String& error)
+{
+    auto* format = formats.findFormatForFileExtension (file.getFileExtension());
+
+    if (format == nullptr)
+    {
+        error = "Kein Ausgabeformat für " + file.getFileName();
+        return {};
+    }
+
+    // FileOutputStream hängt sonst an eine bestehende Datei an
+    if (file.existsAsFile() && ! file.deleteFile())
+    {
+        error = "Kann " + file.getFullPathName() + " nicht überschreiben";
+        return {};
+    }
+
+    std::unique_ptr<juce::OutputStream> stream (file.createOutputStream (1 << 20));
+
+    if (stream == nullptr)
+    {
+        error = "Kann " + file.getFullPathName() + " nicht öffnen";
+        return {};
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), sampleRate,
+                                                                              channels, bitsPerSample, {}, 0));
+    if (writer == nullptr)
+    {
+        error = format->getFormatName() + " unterstützt " + juce::String (bitsPerSample) + " Bit / "
+              + juce::String (channels.size()) + " Kanäle nicht";
+        return {};
+    }
+
+    stream.release(); // gehört jetzt dem Writer
+    return writer;
+}
+
+juce::Result OfflineRender::process (CoherentUpmixAudioProcessor& processor, juce::AudioFormatReader& reader,
+                                     const WriteFunction& write, const Settings& settings, Stats& stats,
+                                     Region region)
+{
+    const int numInputs = (int) reader.numChannels;
+
+    if (numInputs != 2 && numInputs != 6)
+        return juce::Result::fail ("Nur Stereo- oder 5.1-Eingänge, nicht " + juce::String (numInputs) + " Kanäle");
+
+    const int numOutputs = settings.outputChannels;
+
+    if (numInputs == 6 && numOutputs != 6)
+        return juce::Result::fail ("5.1-Eingänge nur nach 5.1, nicht nach " + juce::String (numOutputs) + " Kanälen");
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add (numInputs == 2 ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::create5point1());
+    layout.outputBuses.add (getOutputChannelSet (settings));
+
+    if (! processor.setBusesLayout (layout))
+        return juce::Result::fail ("Buslayout wird nicht unterstützt");
+
+    const double sampleRate = reader.sampleRate;
+    const int blockSize     = juce::jmax (16, settings.blockSize);
+
+    processor.setNonRealtime (true);
+    processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+    processor.prepareToPlay (sampleRate, blockSize);
+
+    const juce::int64 start   = juce::jlimit ((juce::int64) 0, reader.lengthInSamples, region.start);
+    const juce::int64 length  = region.length < 0 ? reader.lengthInSamples - start
+                                                  : juce::jmin (region.length, reader.lengthInSamples - start);
+    const juce::int64 preRoll = juce::jlimit ((juce::int64) 0, start, region.preRoll);
+    const int latency         = processor.getLatencySamples();
+
+    const int numChannels = juce::jmax (numInputs, numOutputs);
+    juce::AudioBuffer<float> buffer (numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    stats = {};
+    stats.sampleRate = sampleRate;
+
+    const double startTime = now();
+    juce::int64 readPosition = start - preRoll;
+    juce::int64 written      = 0;
+    juce::int64 toSkip       = preRoll + latency;
+    const juce::int64 end    = start + length + latency;
+
+    // Bis end lesen (hinter dem Dateiende liefert der Reader Nullen), damit nach
+    // dem Verwerfen von Pre-Roll und Latenz genau length Samples geschrieben werden.
+    while (written < length)
+    {
+        const int numSamples = (int) juce::jmin ((juce::int64) blockSize, end - readPosition);
+
+        buffer.setSize (numChannels, numSamples, false, false, true);
+        reader.read (buffer.getArrayOfWritePointers(), numInputs, readPosition, numSamples);
+
+        for (int ch = numInputs; ch < numChannels; ++ch)
+            buffer.clear (ch, 0, numSamples);
+
+        readPosition += numSamples;
+
+        const double processStart = now();
+        processor.processBlock (buffer, midi);
+        stats.processSeconds += now() - processStart;
+
+        const int skip = (int) juce::jmin (toSkip, (juce::int64) numSamples);
+        toSkip -= skip;
+
+        const int numToWrite = (int) juce::jmin ((juce::int64) (numSamples - skip), length - written);
+
+        if (numToWrite > 0)
+        {
+            const float* channels[OutputLayout::maxChannels] {};
+            for (int ch = 0; ch < numOutputs; ++ch)
+                channels[ch] = buffer.getReadPointer (ch, skip);
+
+            if (! write (channels, numToWrite))
+                return juce::Result::fail ("Schreibfehler");
+
+            written += numToWrite;
+        }
+    }
+
+    processor.releaseResources();
+
+    stats.numFrames   = written;
+    stats.wallSeconds = now() - startTime;
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRender::renderFile (CoherentUpmixAudioProcessor& processor, juce::AudioFormatManager& formats,
+                                        const juce::File& input, const juce::File& output,
+                                        const Settings& settings, Stats& stats)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+    if (reader == nullptr)
+        return juce::Result::fail ("Kann " + input.getFullPathName() + " nicht lesen");
+
+    juce::String error;
+    auto writer = createWriter (formats, output, reader->sampleRate, getOutputChannelSet (settings), settings.bitsPerSample, error);
+
+    if (writer == nullptr)
+        return juce::Result::fail (error);
+
+    const double startTime = now();
+    auto result = process (processor, *reader,
+                           [&writer] (const float* const* channels, int numSamples)
+                           {
+                               return writer->writeFromFloatArrays (channels, (int) writer->getNumChannels(), numSamples);
+                           },
+                           settings, stats);
+
+    writer.reset(); // Header schreiben und Datei schließen gehört zur Laufzeit
+    stats.wallSeconds = now() - startTime;
+    return result;
+}
+
+juce::String OfflineRender::describe (const Stats& stats)
+{
+    return formatDuration (stats.getAudioSeconds()) + " Audio in "
+         + juce::String (stats.wallSeconds, 2) + " s - "
+         + juce::String (stats.getRealtimeFactor(), 1) + "x Echtzeit (DSP allein "
+         + juce::String (stats.getDspRealtimeFactor(), 1) + "x)";
+}
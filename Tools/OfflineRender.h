@@ -0,0 +1,85 @@
+/*
+==============================================================================
+    OfflineRender.h
+
+    Streamt eine Audiodatei ohne Editor und ohne Audio-Device durch
+    CoherentUpmixAudioProcessor::processBlock - so schnell es geht.
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "OutputLayout.h"
+
+namespace OfflineRender
+{
+    struct Settings
+    {
+        int blockSize     = 8192;   // groß: weniger Aufrufe, Filter bleiben trotzdem exakt
+        int bitsPerSample = 24;     // 16, 24 oder 32 (float, nur WAV)
+        int outputChannels = 6;     // 2, 6, 8 oder 12 = Stereo, 5.1, 7.1, 7.1.4 (nur von Stereo)
+    };
+
+    /** Ausgangsbus für settings.outputChannels, Kanäle in JUCE-Reihenfolge. */
+    inline juce::AudioChannelSet getOutputChannelSet (const Settings& settings)
+    {
+        return OutputLayout::getChannelSet (settings.outputChannels);
+    }
+
+    /** Prüft --outputs: 2, 6, 8 oder 12. */
+    inline bool isSupportedOutputCount (int numChannels) noexcept
+    {
+        return numChannels == 2 || numChannels == 6 || numChannels == 8 || numChannels == 12;
+    }
+
+    struct Stats
+    {
+        juce::int64 numFrames = 0;
+        double sampleRate     = 0.0;
+        double wallSeconds    = 0.0;   // inkl. Lesen/Schreiben
+        double processSeconds = 0.0;   // nur processBlock
+
+        double getAudioSeconds() const noexcept      { return sampleRate > 0.0 ? (double) numFrames / sampleRate : 0.0; }
+        double getRealtimeFactor() const noexcept    { return wallSeconds > 0.0 ? getAudioSeconds() / wallSeconds : 0.0; }
+        double getDspRealtimeFactor() const noexcept { return processSeconds > 0.0 ? getAudioSeconds() / processSeconds : 0.0; }
+    };
+
+    /** WAV (wird ab 4 GB automatisch RF64), FLAC oder AIFF - nach Dateiendung. */
+    std::unique_ptr<juce::AudioFormatWriter> createWriter (juce::AudioFormatManager& formats,
+                                                           const juce::File& file, double sampleRate,
+                                                           const juce::AudioChannelSet& channels,
+                                                           int bitsPerSample, juce::String& error);
+
+    /** Ausschnitt der Quelle. preRoll Samples vor start werden mitgerechnet
+        (Filter, Hüllkurven, Delay und Limiter laufen ein), aber nicht geschrieben.
+    */
+    struct Region
+    {
+        juce::int64 start   = 0;
+        juce::int64 length  = -1;   // -1 = bis zum Dateiende
+        juce::int64 preRoll = 0;
+    };
+
+    /** Nimmt die fertigen Ausgangskanäle entgegen (settings.outputChannels, direkt
+        in den Writer oder in einen Write-Behind-Puffer). false = Schreibfehler.
+    */
+    using WriteFunction = std::function<bool (const float* const* channels, int numSamples)>;
+
+    /** Stellt die Busse passend zum Reader ein (2 → settings.outputChannels oder 5.1 → 5.1), ruft
+        prepareToPlay und verarbeitet die ganze Datei. Latenz des Prozessors
+        wird ausgeglichen, die Ausgabe ist genauso lang wie die Eingabe (bzw. region.length).
+    */
+    juce::Result process (CoherentUpmixAudioProcessor& processor, juce::AudioFormatReader& reader,
+                          const WriteFunction& write, const Settings& settings, Stats& stats,
+                          Region region = {});
+
+    /** Komfort: Dateien öffnen, process() aufrufen, Ausgabe schließen. */
+    juce::Result renderFile (CoherentUpmixAudioProcessor& processor, juce::AudioFormatManager& formats,
+                             const juce::File& input, const juce::File& output,
+                             const Settings& settings, Stats& stats);
+
+    /** "1:02:03 Audio in 45.3 s - 82.1x Echtzeit (DSP allein 140.2x)" */
+    juce::String describe (const Stats& stats);
+}
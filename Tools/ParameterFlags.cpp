@@ -0,0 +1,125 @@
+/*
+==============================================================================
+    ParameterFlags.cpp
+==============================================================================
+*/
+
+#include "ParameterFlags.h"
+
+namespace
+{
+    juce::RangedAudioParameter* findParameter (juce::AudioProcessor& processor, const juce::String& id)
+    {
+        for (auto* p : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (p))
+                if (ranged->getParameterID() == id)
+                    return ranged;
+
+        return nullptr;
+    }
+
+    bool isNumber (const juce::String& text)
+    {
+        return text.isNotEmpty() && text.containsOnly ("0123456789.-+eE");
+    }
+
+    /** Text → normalisierter Wert, oder -1 bei ungültiger Eingabe. */
+    float toNormalised (juce::RangedAudioParameter& param, const juce::String& text)
+    {
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*> (&param))
+        {
+            int index = choice->choices.indexOf (text, true);
+
+            if (index < 0 && text.containsOnly ("0123456789") && text.isNotEmpty())
+                index = text.getIntValue();
+
+            return juce::isPositiveAndBelow (index, choice->choices.size())
+                       ? choice->convertTo0to1 ((float) index) : -1.0f;
+        }
+
+        if (dynamic_cast<juce::AudioParameterBool*> (&param) != nullptr)
+        {
+            const auto t = text.toLowerCase();
+            if (t == "1" || t == "on"  || t == "true"  || t == "yes") return 1.0f;
+            if (t == "0" || t == "off" || t == "false" || t == "no")  return 0.0f;
+            return -1.0f;
+        }
+
+        if (! isNumber (text))
+            return -1.0f;
+
+        const auto& range = param.getNormalisableRange();
+        const float value = text.getFloatValue();
+
+        if (value < range.start || value > range.end)
+            return -1.0f;
+
+        return param.convertTo0to1 (value);
+    }
+}
+
+juce::Result ParameterFlags::apply (juce::AudioProcessor& processor, const CommandLine& commandLine,
+                                    const juce::StringArray& toolOptions)
+{
+    const auto& options = commandLine.getOptions();
+
+    for (int i = 0; i < options.size(); ++i)
+    {
+        const auto id    = options.getAllKeys()[i];
+        const auto value = options.getAllValues()[i];
+
+        if (toolOptions.contains (id))
+            continue;
+
+        auto* param = findParameter (processor, id);
+
+        if (param == nullptr)
+            return juce::Result::fail ("Unbekannte Option --" + id);
+
+        const float normalised = toNormalised (*param, value.trim());
+
+        if (normalised < 0.0f)
+            return juce::Result::fail ("Ungültiger Wert für --" + id + ": " + value);
+
+        // Schreibt synchron in den Rohwert der APVTS - processBlock sieht ihn sofort
+        param->setValueNotifyingHost (normalised);
+    }
+
+    return juce::Result::ok();
+}
+
+juce::String ParameterFlags::describe (juce::AudioProcessor& processor)
+{
+    juce::String text;
+
+    for (auto* p : processor.getParameters())
+    {
+        auto* param = dynamic_cast<juce::RangedAudioParameter*> (p);
+
+        if (param == nullptr)
+            continue;
+
+        text << "  --" << param->getParameterID().paddedRight (' ', 18) << param->getName (64);
+
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*> (param))
+        {
+            const int defaultIndex = juce::roundToInt (choice->convertFrom0to1 (choice->getDefaultValue()));
+            text << "\n";
+            for (int i = 0; i < choice->choices.size(); ++i)
+                text << "      " << i << " = \"" << choice->choices[i] << "\""
+                     << (i == defaultIndex ? "  (Default)" : "") << "\n";
+        }
+        else if (dynamic_cast<juce::AudioParameterBool*> (param) != nullptr)
+        {
+            text << "  on|off  (Default " << (param->getDefaultValue() >= 0.5f ? "on" : "off") << ")\n";
+        }
+        else
+        {
+            const auto& range = param->getNormalisableRange();
+            text << "  " << range.start << " .. " << range.end
+                 << "  (Default " << range.convertFrom0to1 (param->getDefaultValue()) << ")\n";
+        }
+    }
+
+    return text;
+}
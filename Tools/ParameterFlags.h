@@ -0,0 +1,26 @@
+/*
+==============================================================================
+    ParameterFlags.h
+
+    Jeder APVTS-Parameter des Prozessors ist als "--<parameterID> <wert>"
+    setzbar. Die Liste wird zur Laufzeit aus dem Prozessor gelesen - neue
+    Parameter brauchen hier keine Änderung.
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CommandLine.h"
+
+namespace ParameterFlags
+{
+    /** Setzt alle Parameter-Optionen. Unbekannte Optionen (nicht in toolOptions
+        und kein Parameter) und ungültige Werte liefern einen Fehler.
+    */
+    juce::Result apply (juce::AudioProcessor& processor, const CommandLine& commandLine,
+                        const juce::StringArray& toolOptions);
+
+    /** Hilfetext: ID, Bereich bzw. Auswahlwerte und Default jedes Parameters. */
+    juce::String describe (juce::AudioProcessor& processor);
+}
@@ -0,0 +1,268 @@
+/*
+==============================================================================
+    SegmentRender.cpp
+==============================================================================
+*/
+
+#include "SegmentRender.h"
+
+#include <thread>
+
+namespace
+{
+    double now() noexcept { return juce::Time::getMillisecondCounterHiRes() * 0.001; }
+
+    juce::int64 roundUpTo (juce::int64 value, juce::int64 multiple)
+    {
+        return ((value + multiple - 1) / multiple) * multiple;
+    }
+
+    /** Zwischendateien werden in jedem Fall wieder gelöscht. */
+    struct TemporaryFiles
+    {
+        ~TemporaryFiles()
+        {
+            for (auto& f : files)
+                f.deleteFile();
+        }
+
+        juce::File add (const juce::File& output, const juce::String& suffix)
+        {
+            auto f = output.getSiblingFile (output.getFileNameWithoutExtension() + "." + suffix + ".tmp.wav");
+            files.add (f);
+            return f;
+        }
+
+        juce::Array<juce::File> files;
+    };
+
+    struct Segment
+    {
+        OfflineRender::Region region;
+        juce::File file;
+        OfflineRender::Stats stats;
+        juce::Result result { juce::Result::ok() };
+    };
+
+    /** Ein Segment in eine 32-Bit-Float-WAV rendern (verlustfrei für das Zusammensetzen). */
+    juce::Result renderSegment (CoherentUpmixAudioProcessor& processor, juce::AudioFormatManager& formats,
+                                const juce::File& input, Segment& segment, const OfflineRender::Settings& settings)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+        if (reader == nullptr)
+            return juce::Result::fail ("Kann " + input.getFullPathName() + " nicht lesen");
+
+        juce::String error;
+        auto writer = OfflineRender::createWriter (formats, segment.file, reader->sampleRate,
+                                                   OfflineRender::getOutputChannelSet (settings), 32, error);
+
+        if (writer == nullptr)
+            return juce::Result::fail (error);
+
+        return OfflineRender::process (processor, *reader,
+                                       [&writer] (const float* const* channels, int numSamples)
+                                       {
+                                           return writer->writeFromFloatArrays (channels, (int) writer->getNumChannels(), numSamples);
+                                       },
+                                       settings, segment.stats, segment.region);
+    }
+
+    /** Liest genau numSamples ab position - false bei Lesefehler. */
+    bool readBlock (juce::AudioFormatReader& reader, juce::AudioBuffer<float>& buffer,
+                    juce::int64 position, int numSamples)
+    {
+        buffer.setSize ((int) reader.numChannels, numSamples, false, false, true);
+        return reader.read (buffer.getArrayOfWritePointers(), (int) reader.numChannels, position, numSamples);
+    }
+}
+
+juce::Result SegmentRender::renderFile (juce::AudioFormatManager& formats, const juce::File& input, const juce::File& output,
+                                        const Settings& settings,
+                                        const std::function<void (CoherentUpmixAudioProcessor&)>& configureProcessor,
+                                        Result& result)
+{
+    std::unique_ptr<juce::AudioFormatReader> probe (formats.createReaderFor (input));
+
+    if (probe == nullptr)
+        return juce::Result::fail ("Kann " + input.getFullPathName() + " nicht lesen");
+
+    const double sampleRate  = probe->sampleRate;
+    const juce::int64 length = probe->lengthInSamples;
+    probe.reset();
+
+    const double startTime = now();
+    const int blockSize    = juce::jmax (16, settings.render.blockSize);
+
+    // Segmentgrenzen und Pre-Roll liegen auf einem Raster aus blockSize * stride:
+    // dieselben Blockgrenzen wie beim seriellen Rendern, und der inkrementelle
+    // 5.1-Detektor prüft in jedem Block dieselbe Phase.
+    const juce::int64 grid     = (juce::int64) blockSize * SurroundContentDetector::stride;
+    const juce::int64 preRoll  = roundUpTo ((juce::int64) (settings.preRollSeconds * sampleRate), grid);
+    const int crossfade        = juce::jmax (1, juce::roundToInt (settings.crossfadeMs * 0.001 * sampleRate));
+
+    // Segmente kürzer als der Pre-Roll lohnen sich nicht
+    const juce::int64 minSegmentLength = juce::jmax (grid, preRoll, (juce::int64) (4 * crossfade));
+    const int numSegmentsWanted = (int) juce::jlimit ((juce::int64) 1, juce::jmax ((juce::int64) 1, length / minSegmentLength),
+                                                      (juce::int64) juce::jmax (1, settings.numSegments));
+    const juce::int64 segmentLength = juce::jmax (grid, roundUpTo (length / numSegmentsWanted, grid));
+
+    // Abrunden: das letzte Segment nimmt den Rest mit, ist also nie kürzer als die Überblendung
+    const int numSegments = (int) juce::jmax ((juce::int64) 1, length / segmentLength);
+
+    TemporaryFiles temporaryFiles;
+    std::vector<Segment> segments ((size_t) numSegments);
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const juce::int64 begin = (juce::int64) i * segmentLength;
+        const juce::int64 end   = i + 1 < numSegments ? begin + segmentLength + crossfade : length;
+
+        auto& s = segments[(size_t) i];
+        s.region.start   = begin;
+        s.region.length  = end - begin;
+        s.region.preRoll = i == 0 ? 0 : preRoll;
+        s.file = temporaryFiles.add (output, "part" + juce::String (i));
+    }
+
+    // Prozessoren auf dem Haupt-Thread anlegen (APVTS), gerechnet wird parallel
+    std::vector<std::unique_ptr<CoherentUpmixAudioProcessor>> processors;
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        processors.push_back (std::make_unique<CoherentUpmixAudioProcessor>());
+        configureProcessor (*processors.back());
+    }
+
+    {
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < numSegments; ++i)
+            threads.emplace_back ([&, i]
+            {
+                auto& s = segments[(size_t) i];
+                s.result = renderSegment (*processors[(size_t) i], formats, input, s, settings.render);
+            });
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+    double criticalProcessSeconds = 0.0;
+
+    for (auto& s : segments)
+    {
+        if (s.result.failed())
+            return s.result;
+
+        criticalProcessSeconds = juce::jmax (criticalProcessSeconds, s.stats.processSeconds);
+    }
+
+    // Optional: Referenz seriell rendern (Float, vor jeder Quantisierung vergleichbar)
+    std::unique_ptr<juce::AudioFormatReader> serialReader;
+
+    if (settings.verify)
+    {
+        const auto serialFile = temporaryFiles.add (output, "serial");
+        auto render = settings.render;
+        render.bitsPerSample = 32;
+
+        OfflineRender::Stats serialStats;
+        auto serialResult = OfflineRender::renderFile (*processors.front(), formats, input, serialFile, render, serialStats);
+
+        if (serialResult.failed())
+            return serialResult;
+
+        result.serialWallSeconds = serialStats.wallSeconds;
+        serialReader.reset (formats.createReaderFor (serialFile));
+    }
+
+    // Zusammensetzen: Mitte direkt kopieren, an den Grenzen linear überblenden
+    juce::String error;
+    const auto outputChannels = OfflineRender::getOutputChannelSet (settings.render);
+    const int numOutputs      = outputChannels.size();
+    auto writer = OfflineRender::createWriter (formats, output, sampleRate, outputChannels, settings.render.bitsPerSample, error);
+
+    if (writer == nullptr)
+        return juce::Result::fail (error);
+
+    juce::AudioBuffer<float> buffer (numOutputs, blockSize), tail (numOutputs, crossfade), reference (numOutputs, blockSize);
+    juce::int64 outputPosition = 0;
+    double maxAbsError = 0.0;
+
+    auto emit = [&] (const juce::AudioBuffer<float>& block, int numSamples)
+    {
+        if (serialReader != nullptr && readBlock (*serialReader, reference, outputPosition, numSamples))
+            for (int ch = 0; ch < numOutputs; ++ch)
+                for (int n = 0; n < numSamples; ++n)
+                    maxAbsError = juce::jmax (maxAbsError, (double) std::abs (block.getSample (ch, n) - reference.getSample (ch, n)));
+
+        outputPosition += numSamples;
+        return writer->writeFromAudioSampleBuffer (block, 0, numSamples);
+    };
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        std::unique_ptr<juce::AudioFormatReader> part (formats.createReaderFor (segments[(size_t) i].file));
+
+        if (part == nullptr)
+            return juce::Result::fail ("Segment " + juce::String (i) + " nicht lesbar");
+
+        const bool hasNext       = i + 1 < numSegments;
+        const juce::int64 keepTo = part->lengthInSamples - (hasNext ? crossfade : 0);
+        juce::int64 position     = 0;
+
+        if (i > 0)
+        {
+            if (! readBlock (*part, buffer, 0, crossfade))
+                return juce::Result::fail ("Lesefehler in Segment " + juce::String (i));
+
+            for (int ch = 0; ch < numOutputs; ++ch)
+            {
+                auto* dst = buffer.getWritePointer (ch);
+                const auto* fadeOut = tail.getReadPointer (ch);
+
+                for (int n = 0; n < crossfade; ++n)
+                {
+                    const float w = ((float) n + 0.5f) / (float) crossfade;
+                    dst[n] = fadeOut[n] + w * (dst[n] - fadeOut[n]);
+                }
+            }
+
+            if (! emit (buffer, crossfade))
+                return juce::Result::fail ("Schreibfehler");
+
+            position = crossfade;
+        }
+
+        while (position < keepTo)
+        {
+            const int numSamples = (int) juce::jmin ((juce::int64) blockSize, keepTo - position);
+
+            if (! readBlock (*part, buffer, position, numSamples) || ! emit (buffer, numSamples))
+                return juce::Result::fail ("Lese-/Schreibfehler in Segment " + juce::String (i));
+
+            position += numSamples;
+        }
+
+        if (hasNext && ! part->read (tail.getArrayOfWritePointers(), numOutputs, keepTo, crossfade))
+            return juce::Result::fail ("Lesefehler in Segment " + juce::String (i));
+    }
+
+    writer.reset();
+
+    result.numSegments            = numSegments;
+    result.stats.sampleRate       = sampleRate;
+    result.stats.numFrames        = outputPosition;
+    result.stats.processSeconds   = criticalProcessSeconds;
+    result.stats.wallSeconds      = now() - startTime - result.serialWallSeconds;
+    result.verified               = serialReader != nullptr;
+    result.maxAbsError            = maxAbsError;
+
+    if (result.verified && juce::Decibels::gainToDecibels (maxAbsError, -200.0) > settings.maxErrorDecibels)
+        return juce::Result::fail ("Abweichung zum seriellen Rendern "
+                                   + juce::String (juce::Decibels::gainToDecibels (maxAbsError), 1) + " dB liegt über "
+                                   + juce::String (settings.maxErrorDecibels, 1) + " dB");
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,47 @@
+/*
+==============================================================================
+    SegmentRender.h
+
+    Eine einzelne lange Datei auf mehrere Prozessor-Instanzen verteilen.
+
+    Jedes Segment startet pre-roll Samples früher, damit Neo:6-Steuerung,
+    Transient-Hüllkurven, Linkwitz-Riley-Filter, Surround-Delay und Limiter
+    eingeschwungen sind, bevor geschrieben wird. Die Segmente überlappen um
+    crossfade Samples und werden linear überblendet - die Signale sind dort
+    nahezu identisch, eine lineare Blende hält die Summe exakt.
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OfflineRender.h"
+
+namespace SegmentRender
+{
+    struct Settings
+    {
+        OfflineRender::Settings render;
+        int numSegments       = juce::SystemStats::getNumCpus();
+        double preRollSeconds = 2.0;
+        double crossfadeMs    = 20.0;
+
+        bool verify            = false;  // zusätzlich seriell rendern und vergleichen
+        double maxErrorDecibels = -90.0;
+    };
+
+    struct Result
+    {
+        OfflineRender::Stats stats;
+        int numSegments = 0;
+
+        bool verified      = false;
+        double maxAbsError = 0.0;     // nur mit verify
+        double serialWallSeconds = 0.0;
+    };
+
+    juce::Result renderFile (juce::AudioFormatManager& formats, const juce::File& input, const juce::File& output,
+                             const Settings& settings,
+                             const std::function<void (CoherentUpmixAudioProcessor&)>& configureProcessor,
+                             Result& result);
+}
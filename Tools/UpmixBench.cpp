@@ -0,0 +1,1173 @@
+/*
+==============================================================================
+    UpmixBench.cpp
+
+    Benchmark für processBlock und die einzelnen DSP-Stufen:
+
+        UpmixBench [--quick] [--seconds 0.05] [--filter <text>]
+                   [--json ergebnis.json] [--baseline alt.json] [--max-regression 10]
+                   [--<parameterID> <wert> ...]
+
+    processBlock läuft für jeden ProcessingMode, Blockgrößen 16..4096,
+    Sampleraten 44.1..192 kHz und die Layouts 2→5.1, 5.1→5.1, 2→7.1 und
+    2→7.1.4, Coherent und Spectral zusätzlich im Host-Bypass (processBlockBypassed/…). engine/…
+    misst die Engine allein, je einmal mit den spezialisierten processChunk-
+    Instanzen und dem generischen Pfad (…/specialised, …/generic). Die Stufen
+    (Crossover, Band-Splitter, Dialog-Bandpass, Neo:6-Band, Transient-Matrix
+    mit und ohne Dialog, Delay, Kompressor, Limiter) sind so konfiguriert
+    wie in UpmixEngine::prepare. Vorab werden die Matrix-
+    Kernels gegen UpmixKernels::reference geprüft (höchstens
+    UpmixKernels::tolerance), die Biquad-Bänke gegen die JUCE-Filter
+    (höchstens -110 dB Abweichung) und die spezialisierten Instanzen
+    gegen den generischen Pfad (beide bitgleich), außerdem 7.1/7.1.4 gegen
+    5.1 auf den gemeinsamen Kanälen und der Host-Bypass gegen den um die
+    Latenz verzögerten Eingang (bitgleich); ein Fehler lässt das
+    Programm mit Exit-Code 1 enden.
+
+    Gemessen wird der Median aus fünf Durchgängen - ns pro Sample(frame) und
+    der Echtzeitfaktor. Mit --baseline wird jede Zeile gegen eine frühere
+    JSON-Datei verglichen.
+==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "CommandLine.h"
+#include "ParameterFlags.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+
+namespace
+{
+    const juce::StringArray switches    { "help", "quick" };
+    const juce::StringArray toolOptions { "help", "quick", "seconds", "filter", "json", "baseline", "max-regression" };
+
+    const juce::StringArray modeNames { "Coherent", "Neo6", "ProLogicII", "Transient", "Downmix", "PassThrough", "Spectral", "PCA" };
+
+    struct Case
+    {
+        juce::String name;
+        double sampleRate = 48000.0;
+        int blockSize     = 512;
+        double nsPerSample    = 0.0;   // Median
+        double minNsPerSample = 0.0;
+        double realtimeFactor = 0.0;
+    };
+
+    //==============================================================================
+    /** Rauschen (-12 dBFS), reproduzierbar. */
+    juce::AudioBuffer<float> makeNoise (int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> noise (numChannels, numSamples);
+        juce::Random random (0x5eed);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                noise.setSample (ch, i, 0.25f * (2.0f * random.nextFloat() - 1.0f));
+
+        return noise;
+    }
+
+    /** Die Filter der Kette als Biquad-Bänke, belegt wie in UpmixEngine. Der Band-Splitter-
+        Baum (Neo:6) hat einen eigenen Crossover-Zustand, damit beide Pfade parallel laufen.
+    */
+    struct FilterBanks
+    {
+        FilterBanks (double sampleRate, double crossoverHz)
+        {
+            for (auto* bank : { &crossover, &splitterTrunk, &neo6 })
+                UpmixKernels::prepareBiquadBank (*bank, 4, 2);
+
+            UpmixKernels::prepareBiquadBank (dialog, 1, 1);
+
+            for (int stage = 0; stage < 2; ++stage)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    for (auto* bank : { &crossover, &splitterTrunk })
+                    {
+                        UpmixKernels::setBiquadStage (*bank, ch,     stage, UpmixKernels::makeButterworthLowPass  (sampleRate, crossoverHz));
+                        UpmixKernels::setBiquadStage (*bank, ch + 2, stage, UpmixKernels::makeButterworthHighPass (sampleRate, crossoverHz));
+                    }
+
+                    UpmixKernels::setBiquadStage (neo6, ch,     stage, UpmixKernels::makeButterworthLowPass  (sampleRate, 3000.0));
+                    UpmixKernels::setBiquadStage (neo6, ch + 2, stage, UpmixKernels::makeButterworthHighPass (sampleRate, 3000.0));
+                }
+            }
+
+            UpmixKernels::setBiquadStage (dialog, 0, 0, UpmixKernels::makeBandPass (sampleRate, 1500.0, 0.7));
+        }
+
+        /** Stereo in → lp (2), hp (2). */
+        void processCrossover (const float* inL, const float* inR, juce::AudioBuffer<float>& lp,
+                               juce::AudioBuffer<float>& hp, int numSamples) noexcept
+        {
+            const float* inputs[] = { inL, inR, inL, inR };
+            float* outputs[] = { lp.getWritePointer (0), lp.getWritePointer (1), hp.getWritePointer (0), hp.getWritePointer (1) };
+            UpmixKernels::biquadBank (inputs, outputs, numSamples, crossover);
+        }
+
+        /** Dialog-Bandpass auf der Mitte des Hochpasses (1). */
+        void processDialog (const juce::AudioBuffer<float>& hp, juce::AudioBuffer<float>& mid, int numSamples) noexcept
+        {
+            const float* hpL = hp.getReadPointer (0);
+            const float* hpR = hp.getReadPointer (1);
+            float* m = mid.getWritePointer (0);
+
+            for (int i = 0; i < numSamples; ++i)
+                m[i] = 0.5f * (hpL[i] + hpR[i]);
+
+            const float* dialogIn[] = { m };
+            UpmixKernels::biquadBank (dialogIn, &m, numSamples, dialog);
+        }
+
+        /** Stereo in → lp (2) und Neo:6-Bänder (4: tief L/R, hoch L/R) in einem Durchlauf. */
+        void processSplitter (const float* inL, const float* inR, juce::AudioBuffer<float>& lp,
+                              juce::AudioBuffer<float>& bands, int numSamples) noexcept
+        {
+            static constexpr int highPassTaps[] = { 2, 3, 2, 3 };
+            const float* inputs[] = { inL, inR, inL, inR };
+            float* lowPassOutputs[] = { lp.getWritePointer (0), lp.getWritePointer (1), nullptr, nullptr };
+            UpmixKernels::biquadBankTree (inputs, lowPassOutputs, splitterTrunk, highPassTaps,
+                                          bands.getArrayOfWritePointers(), neo6, numSamples);
+        }
+
+        UpmixKernels::BiquadBank crossover, splitterTrunk, neo6, dialog;
+    };
+
+    /** Die früheren fünf JUCE-Filter (zwei LR-Crossover, zwei LR bei 3 kHz, Dialog-Bandpass). */
+    struct JuceFilters
+    {
+        JuceFilters (double sampleRate, int blockSize, float crossoverHz)
+        {
+            const juce::dsp::ProcessSpec stereo { sampleRate, (juce::uint32) blockSize, 2 };
+            const juce::dsp::ProcessSpec mono   { sampleRate, (juce::uint32) blockSize, 1 };
+
+            for (auto* f : { &low, &high, &neo6Low, &neo6High })
+                f->prepare (stereo);
+
+            low.setType (juce::dsp::LinkwitzRileyFilter<float>::Type::lowpass);
+            high.setType (juce::dsp::LinkwitzRileyFilter<float>::Type::highpass);
+            neo6Low.setType (juce::dsp::LinkwitzRileyFilter<float>::Type::lowpass);
+            neo6High.setType (juce::dsp::LinkwitzRileyFilter<float>::Type::highpass);
+            low.setCutoffFrequency (crossoverHz);
+            high.setCutoffFrequency (crossoverHz);
+            neo6Low.setCutoffFrequency (3000.0f);
+            neo6High.setCutoffFrequency (3000.0f);
+
+            dialog.prepare (mono);
+            *dialog.state = *juce::dsp::IIR::Coefficients<float>::makeBandPass (sampleRate, 1500.0f, 0.7f);
+        }
+
+        /** Wie früher im Prozessor: Kopien des Eingangs, jede Kopie durch ihren Filter. */
+        void processCrossover (const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& lp,
+                               juce::AudioBuffer<float>& hp, int numSamples) noexcept
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                lp.copyFrom (ch, 0, input, ch, 0, numSamples);
+                hp.copyFrom (ch, 0, input, ch, 0, numSamples);
+            }
+
+            auto lpBlock = juce::dsp::AudioBlock<float> (lp).getSubBlock (0, (size_t) numSamples);
+            auto hpBlock = juce::dsp::AudioBlock<float> (hp).getSubBlock (0, (size_t) numSamples);
+            low.process  (juce::dsp::ProcessContextReplacing<float> (lpBlock));
+            high.process (juce::dsp::ProcessContextReplacing<float> (hpBlock));
+        }
+
+        /** Neo:6 wie früher: Crossover, Hochpass viermal kopiert, zweiter Crossover bei 3 kHz. */
+        void processSplitter (const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& lp, juce::AudioBuffer<float>& hp,
+                              juce::AudioBuffer<float>& bands, int numSamples) noexcept
+        {
+            processCrossover (input, lp, hp, numSamples);
+
+            for (int ch = 0; ch < 4; ++ch)
+                bands.copyFrom (ch, 0, hp, ch % 2, 0, numSamples);
+
+            juce::dsp::AudioBlock<float> bandBlock (bands);
+            auto bandLow  = bandBlock.getSubsetChannelBlock (0, 2).getSubBlock (0, (size_t) numSamples);
+            auto bandHigh = bandBlock.getSubsetChannelBlock (2, 2).getSubBlock (0, (size_t) numSamples);
+            neo6Low.process  (juce::dsp::ProcessContextReplacing<float> (bandLow));
+            neo6High.process (juce::dsp::ProcessContextReplacing<float> (bandHigh));
+        }
+
+        void processDialog (const juce::AudioBuffer<float>& hp, juce::AudioBuffer<float>& mid, int numSamples) noexcept
+        {
+            auto* m = mid.getWritePointer (0);
+            const auto* hpL = hp.getReadPointer (0);
+            const auto* hpR = hp.getReadPointer (1);
+
+            for (int i = 0; i < numSamples; ++i)
+                m[i] = 0.5f * (hpL[i] + hpR[i]);
+
+            auto midBlock = juce::dsp::AudioBlock<float> (mid).getSubBlock (0, (size_t) numSamples);
+            dialog.process (juce::dsp::ProcessContextReplacing<float> (midBlock));
+        }
+
+        juce::dsp::LinkwitzRileyFilter<float> low, high, neo6Low, neo6High;
+        juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> dialog;
+    };
+
+    /** Ruft processOneBlock wiederholt auf: Warm-up, dann fünf Durchgänge à seconds / 5. */
+    template <typename Function>
+    void measure (Case& c, double seconds, Function&& processOneBlock)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        for (int i = 0; i < 16; ++i)
+            processOneBlock();
+
+        // Anzahl Blöcke pro Durchgang grob kalibrieren
+        const auto calibrationStart = Clock::now();
+        int calibrationBlocks = 0;
+
+        while (std::chrono::duration<double> (Clock::now() - calibrationStart).count() < seconds * 0.1)
+        {
+            processOneBlock();
+            ++calibrationBlocks;
+        }
+
+        const double secondsPerBlock = std::chrono::duration<double> (Clock::now() - calibrationStart).count()
+                                         / juce::jmax (1, calibrationBlocks);
+        const int blocksPerRun = juce::jmax (1, (int) (seconds / 5.0 / juce::jmax (1.0e-9, secondsPerBlock)));
+
+        std::vector<double> runs;
+
+        for (int run = 0; run < 5; ++run)
+        {
+            const auto start = Clock::now();
+
+            for (int i = 0; i < blocksPerRun; ++i)
+                processOneBlock();
+
+            const double elapsed = std::chrono::duration<double, std::nano> (Clock::now() - start).count();
+            runs.push_back (elapsed / ((double) blocksPerRun * c.blockSize));
+        }
+
+        std::sort (runs.begin(), runs.end());
+        c.nsPerSample    = runs[runs.size() / 2];
+        c.minNsPerSample = runs.front();
+        c.realtimeFactor = 1.0e9 / (c.nsPerSample * c.sampleRate);
+    }
+
+    //==============================================================================
+    class Bench
+    {
+    public:
+        Bench (const CommandLine& cl) : commandLine (cl)
+        {
+            quick   = commandLine.has ("quick");
+            seconds = commandLine.get ("seconds", "0.05").getDoubleValue();
+            filter  = commandLine.get ("filter");
+        }
+
+        void runAll()
+        {
+            const juce::Array<double> rates = quick ? juce::Array<double> { 48000.0, 96000.0 }
+                                                    : juce::Array<double> { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+            const juce::Array<int> blockSizes = quick ? juce::Array<int> { 64, 512, 4096 }
+                                                      : juce::Array<int> { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+            checkKernelAccuracy();
+
+            for (auto rate : rates)
+            {
+                checkFilterAccuracy (rate);
+                checkSpecialisedKernels (rate);
+                checkOutputLayouts (rate);
+                checkBypass (rate);
+            }
+
+            for (auto rate : rates)
+                for (auto blockSize : blockSizes)
+                {
+                    // 2→5.1, 5.1→5.1, 2→7.1, 2→7.1.4
+                    for (auto [numInputs, numOutputs] : { std::pair { 2, 6 }, std::pair { 6, 6 }, std::pair { 2, 8 }, std::pair { 2, 12 } })
+                        for (int mode = 0; mode < modeNames.size(); ++mode)
+                            benchProcessBlock (mode, numInputs, numOutputs, rate, blockSize);
+
+                    // Host-Bypass: nur Laufzeitausgleich, mit und ohne STFT-Latenz
+                    for (int mode : { (int) UpmixEngine::modeCoherent, (int) UpmixEngine::modeSpectral })
+                        benchProcessBlock (mode, 2, 6, rate, blockSize, true);
+
+                    // Instanz aus der Funktionstabelle gegen den generischen processChunk
+                    for (int mode = 0; mode < modeNames.size(); ++mode)
+                        for (bool specialised : { false, true })
+                            benchEngine (mode, rate, blockSize, specialised);
+
+                    benchStages (rate, blockSize);
+                }
+        }
+
+        juce::Array<Case> results;
+        int numAccuracyFailures = 0;
+
+    private:
+        bool wants (const juce::String& name) const
+        {
+            return filter.isEmpty() || name.containsIgnoreCase (filter);
+        }
+
+        void report (const Case& c)
+        {
+            std::cout << c.name.paddedRight (' ', 48)
+                      << juce::String (c.nsPerSample, 2).paddedLeft (' ', 10) << " ns/sample"
+                      << juce::String (c.realtimeFactor, 0).paddedLeft (' ', 12) << "x realtime" << std::endl;
+            results.add (c);
+        }
+
+        //==============================================================================
+        /** Matrix-Kernels gegen ihre skalare Referenz (UpmixKernels::reference): Abweichung
+            relativ zu max(1, |Referenz|) höchstens UpmixKernels::tolerance. Konstante und
+            geglättete Gains, Längen mit Rest hinter dem letzten vollen Vektor.
+        */
+        void checkKernelAccuracy()
+        {
+            const juce::String name = "accuracy/kernels";
+
+            if (! wants (name))
+                return;
+
+            constexpr int maxLength = 513;
+
+            // Vollaussteuerung statt -12 dBFS: die Fehler sollen ab Betrag 1 relativ gelten
+            juce::AudioBuffer<float> input (7, maxLength), simdOut (6, maxLength), referenceOut (6, maxLength);
+            juce::Random random (0x5eed);
+
+            for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                for (int i = 0; i < maxLength; ++i)
+                    input.setSample (ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+            const float* in[7];
+            float* s[6];
+            float* r[6];
+
+            for (int ch = 0; ch < 7; ++ch)
+                in[ch] = input.getReadPointer (ch);
+
+            for (int ch = 0; ch < 6; ++ch)
+            {
+                s[ch] = simdOut.getWritePointer (ch);
+                r[ch] = referenceOut.getWritePointer (ch);
+            }
+
+            float maxError = 0.0f;
+
+            auto compare = [&] (int numChannels, int length)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    for (int i = 0; i < length; ++i)
+                    {
+                        const float expected = r[ch][i];
+                        maxError = juce::jmax (maxError, std::abs (s[ch][i] - expected) / juce::jmax (1.0f, std::abs (expected)));
+                    }
+                }
+            };
+
+            for (int length : { 1, 7, 31, 513 })
+            {
+                for (bool ramped : { false, true })
+                {
+                    // Geglättet: von start nach end über die ganze Länge
+                    auto gain = [ramped, length] (float start, float end)
+                    {
+                        return ramped ? UpmixKernels::GainRamp (start, (end - start) / (float) length)
+                                      : UpmixKernels::GainRamp (start);
+                    };
+
+                    const UpmixKernels::CoherentGains coherent { gain (0.2f, 0.7f), gain (2.5f, 0.5f), gain (0.5f, 0.9f), gain (-0.3f, 0.4f) };
+
+                    for (const float* dialog : { (const float*) nullptr, in[2] })
+                    {
+                        simdOut.clear();
+                        referenceOut.clear();
+                        UpmixKernels::coherentMatrix (in[0], in[1], dialog, s[0], s[1], s[2], s[3], s[4], length, coherent);
+                        UpmixKernels::reference::coherentMatrix (in[0], in[1], dialog, r[0], r[1], r[2], r[3], r[4], length, coherent);
+                        compare (5, length);
+                    }
+
+                    const UpmixKernels::ProLogicGains proLogic { gain (0.8f, 0.1f), gain (0.0f, 1.0f) };
+
+                    simdOut.clear();
+                    referenceOut.clear();
+                    UpmixKernels::proLogicMatrix (in[0], in[1], s[0], s[1], s[2], s[3], s[4], length, proLogic);
+                    UpmixKernels::reference::proLogicMatrix (in[0], in[1], r[0], r[1], r[2], r[3], r[4], length, proLogic);
+                    compare (5, length);
+
+                    // Bass aus in[3]/in[4], die Matrix-Ausgänge aus in[0..2], in[5], in[6]
+                    simdOut.clear();
+                    referenceOut.clear();
+                    UpmixKernels::outputMix (in[3], in[4], in[0], in[1], in[2], in[5], in[6],
+                                             s[0], s[1], s[2], s[3], s[4], s[5], length, gain (0.25f, 1.0f));
+                    UpmixKernels::reference::outputMix (in[3], in[4], in[0], in[1], in[2], in[5], in[6],
+                                                        r[0], r[1], r[2], r[3], r[4], r[5], length, gain (0.25f, 1.0f));
+                    compare (6, length);
+                }
+            }
+
+            const bool passed = maxError <= UpmixKernels::tolerance;
+            numAccuracyFailures += passed ? 0 : 1;
+
+            std::cout << (name + " (" + UpmixKernels::getInstructionSetName() + ")").paddedRight (' ', 48)
+                      << juce::String (juce::Decibels::gainToDecibels (maxError, -200.0f), 1).paddedLeft (' ', 10) << " dB max. Abweichung"
+                      << (passed ? "" : "   <-- über UpmixKernels::tolerance") << std::endl;
+        }
+
+        /** Biquad-Bänke gegen die JUCE-Filter: eine Sekunde Rauschen in 512er Blöcken,
+            größte Abweichung über alle Ausgänge. Crossover an der unteren Grenze des
+            Parameterbereichs (40 Hz) - dort ist die Numerik am empfindlichsten.
+        */
+        void checkFilterAccuracy (double sampleRate)
+        {
+            const auto name = "accuracy/filters/" + juce::String ((int) sampleRate);
+
+            if (! wants (name))
+                return;
+
+            constexpr int blockSize = 512;
+            constexpr float crossoverHz = 40.0f;
+            constexpr double maxErrorDb = -110.0;
+
+            FilterBanks banks (sampleRate, crossoverHz);
+            JuceFilters juceFilters (sampleRate, blockSize, crossoverHz);
+
+            const auto noise = makeNoise (2, (int) sampleRate);
+            juce::AudioBuffer<float> input (2, blockSize);
+            juce::AudioBuffer<float> lp (2, blockSize), hp (2, blockSize), bands (4, blockSize), mid (1, blockSize);
+            juce::AudioBuffer<float> lpJuce (2, blockSize), hpJuce (2, blockSize), bandsJuce (4, blockSize), midJuce (1, blockSize);
+
+            float maxError = 0.0f;
+
+            auto compare = [&maxError] (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b, int numSamples)
+            {
+                for (int ch = 0; ch < a.getNumChannels(); ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        maxError = juce::jmax (maxError, std::abs (a.getSample (ch, i) - b.getSample (ch, i)));
+            };
+
+            for (int position = 0; position < noise.getNumSamples(); position += blockSize)
+            {
+                const int n = juce::jmin (blockSize, noise.getNumSamples() - position);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    input.copyFrom (ch, 0, noise, ch, position, n);
+
+                // Der JUCE-Crossover läuft nur einmal; beide Bankpfade vergleichen gegen denselben Tiefpass
+                juceFilters.processSplitter (input, lpJuce, hpJuce, bandsJuce, n);
+                juceFilters.processDialog (hpJuce, midJuce, n);
+
+                banks.processCrossover (input.getReadPointer (0), input.getReadPointer (1), lp, hp, n);
+                banks.processDialog (hp, mid, n);
+                compare (lp, lpJuce, n);
+                compare (hp, hpJuce, n);
+                compare (mid, midJuce, n);
+
+                banks.processSplitter (input.getReadPointer (0), input.getReadPointer (1), lp, bands, n);
+                compare (lp, lpJuce, n);
+                compare (bands, bandsJuce, n);
+            }
+
+            const double errorDb = juce::Decibels::gainToDecibels ((double) maxError, -200.0);
+            const bool passed = errorDb <= maxErrorDb;
+            numAccuracyFailures += passed ? 0 : 1;
+
+            std::cout << name.paddedRight (' ', 48)
+                      << juce::String (errorDb, 1).paddedLeft (' ', 10) << " dB max. Abweichung"
+                      << (passed ? "" : "   <-- über " + juce::String (maxErrorDb, 0) + " dB") << std::endl;
+        }
+
+        //==============================================================================
+        /** Prozessor mit Kommandozeilen-Parametern, Modus und Layout, fertig für processBlock. */
+        void prepareProcessor (CoherentUpmixAudioProcessor& processor, int mode, int numInputs, int numOutputs,
+                               double sampleRate, int blockSize)
+        {
+            ParameterFlags::apply (processor, commandLine, toolOptions);
+
+            auto* modeParam = processor.getValueTreeState().getParameter ("processingMode");
+            modeParam->setValueNotifyingHost (modeParam->convertTo0to1 ((float) mode));
+
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add (numInputs == 2 ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::create5point1());
+            layout.outputBuses.add (OutputLayout::getChannelSet (numOutputs));
+            processor.setBusesLayout (layout);
+            processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+        }
+
+        static void copyNoise (const juce::AudioBuffer<float>& noise, int position, int numChannels,
+                               juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFrom (ch, 0, noise, ch, position, numSamples);
+        }
+
+        /** Spezialisierte processChunk-Instanzen gegen den generischen Pfad: alle Modi und
+            Layouts, Dialog-Anhebung und Center-Kompressor schalten im Wechsel ein und aus.
+            Beide führen dieselben Kernels in derselben Reihenfolge aus - also bitgleich.
+        */
+        void checkSpecialisedKernels (double sampleRate)
+        {
+            const auto name = "accuracy/specialised/" + juce::String ((int) sampleRate);
+
+            if (! wants (name))
+                return;
+
+            constexpr int blockSize = 512;
+
+            const auto noise = makeNoise (6, (int) sampleRate);
+            juce::AudioBuffer<float> generic (OutputLayout::maxChannels, blockSize), specialised (OutputLayout::maxChannels, blockSize);
+            float maxError = 0.0f;
+
+            for (auto [numInputs, numOutputs] : { std::pair { 2, 2 }, std::pair { 2, 6 }, std::pair { 6, 6 }, std::pair { 2, 12 } })
+            {
+                for (int mode = 0; mode < modeNames.size(); ++mode)
+                {
+                    UpmixEngine genericEngine, specialisedEngine;
+                    genericEngine.setSpecialisedKernels (false);
+
+                    UpmixEngine::Parameters params;
+                    params.processingMode = mode;
+
+                    for (auto* engine : { &genericEngine, &specialisedEngine })
+                    {
+                        engine->setParameters (params);
+                        engine->prepare (sampleRate, blockSize, numInputs, numOutputs);
+                    }
+
+                    for (int block = 0; (block + 1) * blockSize <= noise.getNumSamples(); ++block)
+                    {
+                        params.dialogExtract = (block / 8) % 2 != 0 ? 0.6f : 0.0f;
+                        params.centerComp    = (block / 4) % 2 != 0 ? 0.5f : 0.0f;
+
+                        for (auto* buffer : { &generic, &specialised })
+                        {
+                            buffer->clear();
+                            copyNoise (noise, block * blockSize, numInputs, *buffer, blockSize);
+                        }
+
+                        genericEngine.setParameters (params);
+                        specialisedEngine.setParameters (params);
+                        genericEngine.process (juce::dsp::AudioBlock<float> (generic).getSubsetChannelBlock (0, (size_t) juce::jmax (numInputs, numOutputs)));
+                        specialisedEngine.process (juce::dsp::AudioBlock<float> (specialised).getSubsetChannelBlock (0, (size_t) juce::jmax (numInputs, numOutputs)));
+
+                        for (int ch = 0; ch < numOutputs; ++ch)
+                            for (int i = 0; i < blockSize; ++i)
+                                maxError = juce::jmax (maxError, std::abs (generic.getSample (ch, i) - specialised.getSample (ch, i)));
+                    }
+                }
+            }
+
+            const bool passed = maxError == 0.0f;
+            numAccuracyFailures += passed ? 0 : 1;
+
+            std::cout << name.paddedRight (' ', 48)
+                      << juce::String (juce::Decibels::gainToDecibels (maxError, -200.0f), 1).paddedLeft (' ', 10) << " dB max. Abweichung"
+                      << (passed ? "" : "   <-- nicht bitgleich") << std::endl;
+        }
+
+        /** 7.1 und 7.1.4 gegen 5.1: L R C LFE Ls Rs bitgleich in jedem Modus, die
+            abgeleiteten Rear- und Höhenkanäle in den Upmix-Modi nicht stumm. Das Rauschen
+            liegt 12 dB tiefer, damit der gelinkte Limiter sicher nicht eingreift.
+        */
+        void checkOutputLayouts (double sampleRate)
+        {
+            const auto name = "accuracy/layouts/" + juce::String ((int) sampleRate);
+
+            if (! wants (name))
+                return;
+
+            constexpr int blockSize = 512;
+
+            auto noise = makeNoise (2, (int) sampleRate);
+            noise.applyGain (0.25f);
+
+            juce::AudioBuffer<float> reference (6, blockSize), wide (OutputLayout::maxChannels, blockSize);
+            float maxError = 0.0f;
+            int numSilent = 0;
+
+            for (int numOutputs : { 8, 12 })
+            {
+                for (int mode = 0; mode < modeNames.size(); ++mode)
+                {
+                    UpmixEngine referenceEngine, wideEngine;
+
+                    UpmixEngine::Parameters params;
+                    params.processingMode = mode;
+
+                    referenceEngine.setParameters (params);
+                    wideEngine.setParameters (params);
+                    referenceEngine.prepare (sampleRate, blockSize, 2, 6);
+                    wideEngine.prepare (sampleRate, blockSize, 2, numOutputs);
+
+                    const auto& layout = wideEngine.getOutputLayout();
+                    float derivedPeak = 0.0f;
+
+                    for (int block = 0; (block + 1) * blockSize <= noise.getNumSamples(); ++block)
+                    {
+                        for (auto* buffer : { &reference, &wide })
+                        {
+                            buffer->clear();
+                            copyNoise (noise, block * blockSize, 2, *buffer, blockSize);
+                        }
+
+                        referenceEngine.process (juce::dsp::AudioBlock<float> (reference));
+                        wideEngine.process (juce::dsp::AudioBlock<float> (wide).getSubsetChannelBlock (0, (size_t) numOutputs));
+
+                        for (int role = 0; role < 6; ++role)
+                        {
+                            const int ch = layout.getChannelIndex ((OutputLayout::Role) role);
+
+                            for (int i = 0; i < blockSize; ++i)
+                                maxError = juce::jmax (maxError, std::abs (reference.getSample (role, i) - wide.getSample (ch, i)));
+                        }
+
+                        for (int role = OutputLayout::rearLeft; role < OutputLayout::numRoles; ++role)
+                            if (layout.has ((OutputLayout::Role) role))
+                                derivedPeak = juce::jmax (derivedPeak, wide.getMagnitude (layout.getChannelIndex ((OutputLayout::Role) role), 0, blockSize));
+                    }
+
+                    const bool expectsDerived = mode != UpmixEngine::modeDownmix && mode != UpmixEngine::modePassThrough;
+                    numSilent += expectsDerived && derivedPeak == 0.0f ? 1 : 0;
+                }
+            }
+
+            const bool passed = maxError == 0.0f && numSilent == 0;
+            numAccuracyFailures += passed ? 0 : 1;
+
+            std::cout << name.paddedRight (' ', 48)
+                      << juce::String (juce::Decibels::gainToDecibels (maxError, -200.0f), 1).paddedLeft (' ', 10) << " dB max. Abweichung"
+                      << (maxError == 0.0f ? "" : "   <-- nicht bitgleich")
+                      << (numSilent == 0 ? "" : "   <-- Rear/Höhen stumm") << std::endl;
+        }
+
+        /** Host-Bypass: L/R kommen um genau getLatencySamples() verzögert und unverändert
+            heraus, alle anderen Kanäle sind still - mit und ohne STFT-Latenz.
+        */
+        void checkBypass (double sampleRate)
+        {
+            const auto name = "accuracy/bypass/" + juce::String ((int) sampleRate);
+
+            if (! wants (name))
+                return;
+
+            constexpr int blockSize = 512;
+
+            const auto noise = makeNoise (2, (int) sampleRate);
+            juce::AudioBuffer<float> buffer (6, blockSize);
+            float maxError = 0.0f;
+
+            for (int mode : { (int) UpmixEngine::modeCoherent, (int) UpmixEngine::modeSpectral })
+            {
+                UpmixEngine engine;
+                UpmixEngine::Parameters params;
+                params.processingMode = mode;
+                engine.setParameters (params);
+                engine.prepare (sampleRate, blockSize, 2, 6);
+
+                const int latency = engine.getLatencySamples();
+
+                for (int block = 0; (block + 1) * blockSize <= noise.getNumSamples(); ++block)
+                {
+                    const int position = block * blockSize;
+
+                    // Kanäle ohne Eingang mit Müll füllen - der Bypass muss sie leeren
+                    for (int ch = 2; ch < 6; ++ch)
+                        juce::FloatVectorOperations::fill (buffer.getWritePointer (ch), 1.0f, blockSize);
+
+                    copyNoise (noise, position, 2, buffer, blockSize);
+                    engine.processBypassed (juce::dsp::AudioBlock<float> (buffer));
+
+                    for (int ch = 0; ch < 6; ++ch)
+                    {
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            const int source = position + i - latency;
+                            const float expected = ch < 2 && source >= 0 ? noise.getSample (ch, source) : 0.0f;
+                            maxError = juce::jmax (maxError, std::abs (buffer.getSample (ch, i) - expected));
+                        }
+                    }
+                }
+            }
+
+            const bool passed = maxError == 0.0f;
+            numAccuracyFailures += passed ? 0 : 1;
+
+            std::cout << name.paddedRight (' ', 48)
+                      << juce::String (juce::Decibels::gainToDecibels (maxError, -200.0f), 1).paddedLeft (' ', 10) << " dB max. Abweichung"
+                      << (passed ? "" : "   <-- nicht bitgleich") << std::endl;
+        }
+
+        //==============================================================================
+        void benchProcessBlock (int mode, int numInputs, int numOutputs, double sampleRate, int blockSize, bool bypassed = false)
+        {
+            Case c;
+            c.sampleRate = sampleRate;
+            c.blockSize  = blockSize;
+            c.name = juce::String (bypassed ? "processBlockBypassed/" : "processBlock/") + modeNames[mode]
+                   + "/" + juce::String (numInputs) + "-" + juce::String (numOutputs) + "/"
+                   + juce::String ((int) sampleRate) + "/" + juce::String (blockSize);
+
+            if (! wants (c.name))
+                return;
+
+            CoherentUpmixAudioProcessor processor;
+            prepareProcessor (processor, mode, numInputs, numOutputs, sampleRate, blockSize);
+
+            // Eine Sekunde Rauschen, blockweise durchlaufen (die Eingangskopie ist mitgemessen)
+            const auto noise = makeNoise (numInputs, (int) sampleRate);
+            juce::AudioBuffer<float> buffer (juce::jmax (numInputs, numOutputs), blockSize);
+            juce::MidiBuffer midi;
+            int position = 0;
+
+            measure (c, seconds, [&]
+            {
+                if (position + blockSize > noise.getNumSamples())
+                    position = 0;
+
+                copyNoise (noise, position, numInputs, buffer, blockSize);
+
+                position += blockSize;
+
+                if (bypassed)
+                    processor.processBlockBypassed (buffer, midi);
+                else
+                    processor.processBlock (buffer, midi);
+            });
+
+            processor.releaseResources();
+            report (c);
+        }
+
+        /** Die Engine ohne Prozessor (2→5.1, Default-Parameter): einmal mit der Instanz
+            aus der Funktionstabelle, einmal mit dem generischen, zur Laufzeit verzweigten Pfad.
+        */
+        void benchEngine (int mode, double sampleRate, int blockSize, bool specialised)
+        {
+            Case c;
+            c.sampleRate = sampleRate;
+            c.blockSize  = blockSize;
+            c.name = "engine/" + modeNames[mode] + "/2-6/" + juce::String ((int) sampleRate) + "/"
+                   + juce::String (blockSize) + (specialised ? "/specialised" : "/generic");
+
+            if (! wants (c.name))
+                return;
+
+            UpmixEngine engine;
+            UpmixEngine::Parameters params;
+            params.processingMode = mode;
+            engine.setParameters (params);
+            engine.setSpecialisedKernels (specialised);
+            engine.prepare (sampleRate, blockSize, 2, 6);
+
+            const auto noise = makeNoise (2, (int) sampleRate);
+            juce::AudioBuffer<float> buffer (6, blockSize);
+            int position = 0;
+
+            measure (c, seconds, [&]
+            {
+                if (position + blockSize > noise.getNumSamples())
+                    position = 0;
+
+                copyNoise (noise, position, 2, buffer, blockSize);
+
+                position += blockSize;
+                engine.process (juce::dsp::AudioBlock<float> (buffer));
+            });
+
+            engine.release();
+            report (c);
+        }
+
+        //==============================================================================
+        void benchStage (const juce::String& stage, double sampleRate, int blockSize,
+                         const std::function<void (juce::AudioBuffer<float>&)>& process)
+        {
+            Case c;
+            c.sampleRate = sampleRate;
+            c.blockSize  = blockSize;
+            c.name = "stage/" + stage + "/" + juce::String ((int) sampleRate) + "/" + juce::String (blockSize);
+
+            if (! wants (c.name))
+                return;
+
+            const auto noise = makeNoise (6, (int) sampleRate);
+            juce::AudioBuffer<float> buffer (6, blockSize);
+            int position = 0;
+
+            measure (c, seconds, [&]
+            {
+                if (position + blockSize > noise.getNumSamples())
+                    position = 0;
+
+                for (int ch = 0; ch < 6; ++ch)
+                    buffer.copyFrom (ch, 0, noise, ch, position, blockSize);
+
+                position += blockSize;
+                process (buffer);
+            });
+
+            report (c);
+        }
+
+        void benchStages (double sampleRate, int blockSize)
+        {
+            juce::dsp::ProcessSpec stereo { sampleRate, (juce::uint32) blockSize, 2 };
+            juce::dsp::ProcessSpec six    { sampleRate, (juce::uint32) blockSize, 6 };
+
+            juce::AudioBuffer<float> lp (2, blockSize), hp (2, blockSize);
+
+            juce::AudioBuffer<float> bands (4, blockSize), mid (1, blockSize);
+
+            {
+                // Crossover (80 Hz, crossoverFreq-Default) allein, als Neo:6-Band-Splitter-Baum und der Dialog-Bandpass
+                FilterBanks banks (sampleRate, 80.0);
+                JuceFilters juceFilters (sampleRate, blockSize, 80.0f);
+
+                benchStage ("crossover", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    banks.processCrossover (buffer.getReadPointer (0), buffer.getReadPointer (1), lp, hp, blockSize);
+                });
+
+                benchStage ("crossover/juce", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juceFilters.processCrossover (buffer, lp, hp, blockSize);
+                });
+
+                benchStage ("splitter", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    banks.processSplitter (buffer.getReadPointer (0), buffer.getReadPointer (1), lp, bands, blockSize);
+                });
+
+                benchStage ("splitter/juce", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juceFilters.processSplitter (buffer, lp, hp, bands, blockSize);
+                });
+
+                // Dialog-Bandpass des Coherent-Zweigs: Mitte aus den Kanälen 0/1 (stehen für den Hochpass)
+                benchStage ("dialogFilter", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    banks.processDialog (buffer, mid, blockSize);
+                });
+
+                benchStage ("dialogFilter/juce", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juceFilters.processDialog (buffer, mid, blockSize);
+                });
+            }
+
+            for (auto interval : { UpmixKernels::neo6SteerPerSample, UpmixKernels::neo6SteerEvery16, UpmixKernels::neo6SteerEvery32 })
+            {
+                float steerState = 0.0f;
+                const UpmixKernels::Neo6Gains gains { UpmixKernels::GainRamp (0.4f), UpmixKernels::GainRamp (0.0f) };
+
+                benchStage ("neo6Band/" + juce::String ((int) interval), sampleRate, blockSize,
+                            [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    // Eingang = Kanäle 0/1, Ausgänge = 2..5 + 0 (wie processNeo6Band im Prozessor)
+                    UpmixKernels::neo6BandControlRate (buffer.getReadPointer (0), buffer.getReadPointer (1),
+                                                       lp.getWritePointer (0), lp.getWritePointer (1),
+                                                       buffer.getWritePointer (2), buffer.getWritePointer (4), buffer.getWritePointer (5),
+                                                       blockSize, gains, interval, steerState);
+                });
+            }
+
+            {
+                float steerState = 0.0f;
+                const UpmixKernels::Neo6Gains gains { UpmixKernels::GainRamp (0.4f), UpmixKernels::GainRamp (0.0f) };
+
+                benchStage ("neo6Band/reference", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    UpmixKernels::reference::neo6Band (buffer.getReadPointer (0), buffer.getReadPointer (1),
+                                                       lp.getWritePointer (0), lp.getWritePointer (1),
+                                                       buffer.getWritePointer (2), buffer.getWritePointer (4), buffer.getWritePointer (5),
+                                                       blockSize, gains, steerState);
+                });
+            }
+
+            for (bool dialog : { false, true })
+            {
+                // Gains wie surroundBalance 0.5 im Prozessor; der Dialog-Zweig wird vor der Schleife gewählt
+                UpmixKernels::TransientState simdState, referenceState;
+                const UpmixKernels::TransientGains gains { UpmixKernels::GainRamp (0.25f), UpmixKernels::GainRamp (0.5f),
+                                                           UpmixKernels::GainRamp (0.5f), UpmixKernels::GainRamp (dialog ? 0.5f : 0.0f) };
+                const juce::String stage = dialog ? "transient/dialog" : "transient";
+
+                benchStage (stage, sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    UpmixKernels::transientMatrix (buffer.getReadPointer (0), buffer.getReadPointer (1),
+                                                   lp.getWritePointer (0), lp.getWritePointer (1),
+                                                   buffer.getWritePointer (2), buffer.getWritePointer (4), buffer.getWritePointer (5),
+                                                   blockSize, gains, simdState);
+                });
+
+                benchStage (stage + "/reference", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    UpmixKernels::reference::transientMatrix (buffer.getReadPointer (0), buffer.getReadPointer (1),
+                                                              lp.getWritePointer (0), lp.getWritePointer (1),
+                                                              buffer.getWritePointer (2), buffer.getWritePointer (4), buffer.getWritePointer (5),
+                                                              blockSize, gains, referenceState);
+                });
+            }
+
+            for (int bands : { 8, 16 })
+            {
+                UpmixKernels::PcaState pcaSimd, pcaReference;
+                UpmixKernels::preparePcaFilterbank (pcaSimd, sampleRate, bands);
+                UpmixKernels::preparePcaFilterbank (pcaReference, sampleRate, bands);
+                const UpmixKernels::PcaGains gains { UpmixKernels::GainRamp (0.4f), UpmixKernels::GainRamp (0.0f) };
+
+                // Ausgänge wie bei neo6Band: nie in die gelesenen Kanäle 0/1 schreiben
+                benchStage ("pca/" + juce::String (bands), sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    UpmixKernels::pcaUpmix (buffer.getReadPointer (0), buffer.getReadPointer (1),
+                                            lp.getWritePointer (0), lp.getWritePointer (1),
+                                            buffer.getWritePointer (2), buffer.getWritePointer (4), buffer.getWritePointer (5),
+                                            blockSize, gains, pcaSimd);
+                });
+
+                benchStage ("pca/" + juce::String (bands) + "/reference", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    UpmixKernels::reference::pcaUpmix (buffer.getReadPointer (0), buffer.getReadPointer (1),
+                                                       lp.getWritePointer (0), lp.getWritePointer (1),
+                                                       buffer.getWritePointer (2), buffer.getWritePointer (4), buffer.getWritePointer (5),
+                                                       blockSize, gains, pcaReference);
+                });
+            }
+
+            {
+                SurroundDelay delay;
+                delay.prepare (sampleRate, blockSize, 2, UpmixEngine::maxSurroundDelayMs);
+                delay.setDelayMs (0, 20.0, false);
+                delay.setDelayMs (1, 20.0, false);
+
+                benchStage ("delay", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juce::dsp::AudioBlock<float> block (buffer);
+                    delay.process (block.getSubsetChannelBlock (4, 2));
+                });
+            }
+
+            {
+                // Vergleich: die frühere DelayLine mit linearer Interpolation
+                juce::dsp::DelayLine<float> delay { 96000 };
+                delay.prepare (stereo);
+                delay.setMaximumDelayInSamples ((int) sampleRate);
+                delay.setDelay (20.0f * (float) (sampleRate / 1000.0));
+
+                benchStage ("delay/juce", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juce::dsp::AudioBlock<float> block (buffer);
+                    auto surround = block.getSubsetChannelBlock (4, 2);
+                    delay.process (juce::dsp::ProcessContextReplacing<float> (surround));
+                });
+            }
+
+            {
+                SurroundDecorrelator decorrelator;
+                decorrelator.prepare (sampleRate, 2);
+
+                benchStage ("decorrelator", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juce::dsp::AudioBlock<float> block (buffer);
+                    decorrelator.process (block.getSubsetChannelBlock (4, 2));
+                });
+            }
+
+            {
+                juce::dsp::Compressor<float> compressor;
+                compressor.prepare (stereo);
+                compressor.setAttack (5.0f);
+                compressor.setRelease (100.0f);
+                compressor.setThreshold (-15.0f);   // centerComp = 0.5
+                compressor.setRatio (2.5f);
+
+                benchStage ("compressor", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juce::dsp::AudioBlock<float> block (buffer);
+                    auto center = block.getSubsetChannelBlock (2, 1);
+                    compressor.process (juce::dsp::ProcessContextReplacing<float> (center));
+                });
+            }
+
+            for (bool truePeak : { false, true })
+            {
+                LookaheadLimiter limiter;
+                limiter.prepare (sampleRate, blockSize, 6, UpmixEngine::outputLimiterLookaheadMs, UpmixEngine::outputLimiterReleaseMs);
+                limiter.setCeilingDecibels (UpmixEngine::outputCeilingDb);
+                limiter.setTruePeak (truePeak);
+
+                benchStage (truePeak ? "limiter/truePeak" : "limiter", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    limiter.process (juce::dsp::AudioBlock<float> (buffer));
+                });
+            }
+
+            {
+                // Pass-Through/Bypass: nur die Verzögerung, ohne Detektor
+                LookaheadLimiter limiter;
+                limiter.prepare (sampleRate, blockSize, 6, UpmixEngine::outputLimiterLookaheadMs, UpmixEngine::outputLimiterReleaseMs);
+
+                benchStage ("limiter/delayOnly", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    limiter.processDelayOnly (juce::dsp::AudioBlock<float> (buffer));
+                });
+            }
+
+            {
+                // Der frühere Ausgangslimiter als Vergleich
+                juce::dsp::Limiter<float> limiter;
+                limiter.prepare (six);
+                limiter.setRelease (100.0f);
+
+                benchStage ("limiter/juce", sampleRate, blockSize, [&] (juce::AudioBuffer<float>& buffer)
+                {
+                    juce::dsp::AudioBlock<float> block (buffer);
+                    limiter.process (juce::dsp::ProcessContextReplacing<float> (block));
+                });
+            }
+        }
+
+        const CommandLine& commandLine;
+        bool quick = false;
+        double seconds = 0.05;
+        juce::String filter;
+    };
+
+    //==============================================================================
+    juce::var toJson (const juce::Array<Case>& results)
+    {
+        juce::Array<juce::var> cases;
+
+        for (const auto& c : results)
+        {
+            auto* obj = new juce::DynamicObject();
+            obj->setProperty ("name", c.name);
+            obj->setProperty ("sampleRate", c.sampleRate);
+            obj->setProperty ("blockSize", c.blockSize);
+            obj->setProperty ("nsPerSample", c.nsPerSample);
+            obj->setProperty ("minNsPerSample", c.minNsPerSample);
+            obj->setProperty ("realtimeFactor", c.realtimeFactor);
+            cases.add (juce::var (obj));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("instructionSet", juce::String (UpmixKernels::getInstructionSetName()));
+        root->setProperty ("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty ("date", juce::Time::getCurrentTime().toISO8601 (true));
+        root->setProperty ("cases", cases);
+        return juce::var (root);
+    }
+
+    /** Vergleich gegen eine frühere Messung. Liefert die Zahl der Regressionen über maxRegression %. */
+    int compareWithBaseline (const juce::Array<Case>& results, const juce::var& baseline, double maxRegression)
+    {
+        std::map<juce::String, double> before;
+
+        if (auto* cases = baseline["cases"].getArray())
+            for (const auto& c : *cases)
+                before[c["name"].toString()] = (double) c["nsPerSample"];
+
+        int numRegressions = 0;
+        int numCompared = 0;
+        double logSum = 0.0;
+
+        std::cout << "\nVergleich mit Baseline (positiv = langsamer):" << std::endl;
+
+        for (const auto& c : results)
+        {
+            auto it = before.find (c.name);
+
+            if (it == before.end() || it->second <= 0.0)
+                continue;
+
+            const double ratio = c.nsPerSample / it->second;
+            const double percent = (ratio - 1.0) * 100.0;
+            logSum += std::log (ratio);
+            ++numCompared;
+
+            const bool regression = percent > maxRegression;
+            numRegressions += regression ? 1 : 0;
+
+            std::cout << c.name.paddedRight (' ', 48)
+                      << (percent >= 0.0 ? "+" : "") << juce::String (percent, 1) << " %"
+                      << (regression ? "   <-- Regression" : "") << std::endl;
+        }
+
+        if (numCompared > 0)
+            std::cout << "Geometrisches Mittel: " << juce::String ((std::exp (logSum / numCompared) - 1.0) * 100.0, 1)
+                      << " % über " << numCompared << " Fälle" << std::endl;
+
+        return numRegressions;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    CommandLine commandLine (argc, argv, switches);
+
+    if (commandLine.has ("help") || commandLine.getError().isNotEmpty())
+    {
+        CoherentUpmixAudioProcessor processor;
+        std::cout << "UpmixBench [--quick] [--seconds <s>] [--filter <text>] [--json <datei>]\n"
+                     "           [--baseline <datei>] [--max-regression <prozent>] [--<parameterID> <wert> ...]\n\n"
+                  << ParameterFlags::describe (processor) << std::endl;
+        return commandLine.getError().isNotEmpty() ? 1 : 0;
+    }
+
+    {
+        // Parameter-Flags einmal vorab prüfen
+        CoherentUpmixAudioProcessor processor;
+
+        if (auto result = ParameterFlags::apply (processor, commandLine, toolOptions); result.failed())
+        {
+            std::cerr << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "SIMD: " << UpmixKernels::getInstructionSetName() << ", CPU: " << juce::SystemStats::getCpuModel() << "\n" << std::endl;
+
+    Bench bench (commandLine);
+    bench.runAll();
+
+    if (bench.numAccuracyFailures > 0)
+        std::cerr << bench.numAccuracyFailures << " Genauigkeitsprüfung(en) fehlgeschlagen" << std::endl;
+
+    const auto json = toJson (bench.results);
+
+    if (commandLine.has ("json"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (commandLine.get ("json"));
+
+        if (! file.replaceWithText (juce::JSON::toString (json)))
+        {
+            std::cerr << "Kann " << file.getFullPathName() << " nicht schreiben" << std::endl;
+            return 1;
+        }
+    }
+
+    if (commandLine.has ("baseline"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (commandLine.get ("baseline"));
+        const auto baseline = juce::JSON::parse (file);
+
+        if (! baseline.isObject())
+        {
+            std::cerr << "Baseline " << file.getFullPathName() << " ist kein gültiges JSON" << std::endl;
+            return 1;
+        }
+
+        const double maxRegression = commandLine.get ("max-regression", "10").getDoubleValue();
+
+        if (compareWithBaseline (bench.results, baseline, maxRegression) > 0)
+            return 1;
+    }
+
+    return bench.numAccuracyFailures > 0 ? 1 : 0;
+}
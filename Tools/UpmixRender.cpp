@@ -0,0 +1,200 @@
+/*
+==============================================================================
+    UpmixRender.cpp
+
+    Offline-Upmix auf der Kommandozeile, ohne DAW und ohne Display:
+
+        UpmixRender [Optionen] [--<parameterID> <wert> ...] <eingang> <ausgang>
+        UpmixRender [Optionen] --output-dir <ordner> <dateien/ordner ...>
+
+    Eingang: WAV / RF64 / FLAC / AIFF, Stereo oder 5.1.
+    Ausgang: 5.1 (Stereo-Eingänge mit --outputs auch Stereo, 7.1 oder 7.1.4),
+    Format nach Endung (.wav wird ab 4 GB automatisch RF64).
+==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "CommandLine.h"
+#include "ParameterFlags.h"
+#include "OfflineRender.h"
+#include "BatchRender.h"
+#include "SegmentRender.h"
+
+#include <iostream>
+
+namespace
+{
+    const juce::StringArray switches   { "help", "list-parameters", "verify" };
+    const juce::StringArray toolOptions { "help", "list-parameters", "block", "bits", "outputs",
+                                          "output-dir", "jobs", "format",
+                                          "segments", "preroll", "crossfade-ms", "verify", "max-error-db" };
+
+    void printUsage (CoherentUpmixAudioProcessor& processor)
+    {
+        std::cout << "UpmixRender [Optionen] <eingang> <ausgang>\n"
+                     "UpmixRender [Optionen] --output-dir <ordner> <dateien/ordner ...>\n\n"
+                     "Optionen:\n"
+                     "  --block <n>          Blockgröße für processBlock (Default 8192)\n"
+                     "  --bits <16|24|32>    Bittiefe der Ausgabe (Default 24, 32 = float)\n"
+                     "  --outputs <n>        Ausgangskanäle: 2, 6, 8 oder 12 = Stereo, 5.1, 7.1, 7.1.4 (Default 6)\n"
+                     "  --output-dir <dir>   Batch-Modus: alle Eingänge parallel rendern\n"
+                     "  --jobs <n>           Batch: Anzahl Worker (Default: alle Kerne)\n"
+                     "  --format <wav|flac>  Batch: Ausgabeformat (Default wav)\n"
+                     "  --segments <n>       eine Datei in n Segmenten parallel rendern\n"
+                     "  --preroll <s>        Segmente: Einschwingzeit vor jedem Segment (Default 2)\n"
+                     "  --crossfade-ms <ms>  Segmente: Überblendung an den Grenzen (Default 20)\n"
+                     "  --verify             Segmente: seriell gegenrendern und vergleichen\n"
+                     "  --max-error-db <dB>  Segmente: erlaubte Abweichung mit --verify (Default -90)\n"
+                     "  --list-parameters    nur die Parameter auflisten\n\n"
+                     "Parameter:\n"
+                  << ParameterFlags::describe (processor) << std::endl;
+    }
+
+    int runBatch (const CommandLine& commandLine, juce::AudioFormatManager& formats,
+                  const OfflineRender::Settings& renderSettings)
+    {
+        const auto outputDir = juce::File::getCurrentWorkingDirectory().getChildFile (commandLine.get ("output-dir"));
+
+        if (! outputDir.createDirectory())
+        {
+            std::cerr << "Kann " << outputDir.getFullPathName() << " nicht anlegen" << std::endl;
+            return 1;
+        }
+
+        juce::StringArray errors;
+        const auto jobs = BatchRender::createJobs (formats, commandLine.getPositional(), outputDir,
+                                                   "." + commandLine.get ("format", "wav"), errors);
+
+        for (const auto& error : errors)
+            std::cerr << error << std::endl;
+
+        BatchRender::Settings settings;
+        settings.render     = renderSettings;
+        settings.numWorkers = commandLine.getInt ("jobs", settings.numWorkers);
+
+        const auto summary = BatchRender::run (jobs, settings, [&commandLine] (CoherentUpmixAudioProcessor& p)
+        {
+            // Wurde in main() schon an einem Prozessor geprüft
+            ParameterFlags::apply (p, commandLine, toolOptions);
+        });
+
+        std::cout << summary.numFiles << " Dateien, " << juce::String (summary.audioSeconds / 3600.0, 2)
+                  << " h Audio in " << juce::String (summary.wallSeconds, 1) << " s - "
+                  << juce::String (summary.getAudioHoursPerMinute(), 2) << " Audio-Stunden pro Minute";
+
+        if (summary.numFailed > 0)
+            std::cout << ", " << summary.numFailed << " fehlgeschlagen";
+
+        std::cout << std::endl;
+        return (summary.numFailed > 0 || ! errors.isEmpty()) ? 1 : 0;
+    }
+
+    int runSegmented (const CommandLine& commandLine, juce::AudioFormatManager& formats,
+                      const OfflineRender::Settings& renderSettings, const juce::File& input, const juce::File& output)
+    {
+        SegmentRender::Settings settings;
+        settings.render           = renderSettings;
+        settings.numSegments      = commandLine.getInt ("segments", settings.numSegments);
+        settings.preRollSeconds   = commandLine.get ("preroll", juce::String (settings.preRollSeconds)).getDoubleValue();
+        settings.crossfadeMs      = commandLine.get ("crossfade-ms", juce::String (settings.crossfadeMs)).getDoubleValue();
+        settings.verify           = commandLine.has ("verify");
+        settings.maxErrorDecibels = commandLine.get ("max-error-db", juce::String (settings.maxErrorDecibels)).getDoubleValue();
+
+        SegmentRender::Result result;
+        const auto status = SegmentRender::renderFile (formats, input, output, settings,
+                                                       [&commandLine] (CoherentUpmixAudioProcessor& p)
+                                                       {
+                                                           ParameterFlags::apply (p, commandLine, toolOptions);
+                                                       },
+                                                       result);
+
+        if (result.numSegments > 0)
+            std::cout << input.getFileName() << " -> " << output.getFileName() << " (" << result.numSegments
+                      << " Segmente): " << OfflineRender::describe (result.stats) << std::endl;
+
+        if (result.verified)
+            std::cout << "Abweichung zum seriellen Rendern: "
+                      << juce::String (juce::Decibels::gainToDecibels (result.maxAbsError, -200.0), 1) << " dB, seriell "
+                      << juce::String (result.serialWallSeconds, 2) << " s - Beschleunigung "
+                      << juce::String (result.serialWallSeconds / juce::jmax (1.0e-9, result.stats.wallSeconds), 2) << "x"
+                      << std::endl;
+
+        if (status.failed())
+        {
+            std::cerr << input.getFileName() << ": " << status.getErrorMessage() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    // APVTS braucht einen MessageManager (Timer), auch wenn er nie läuft
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    CommandLine commandLine (argc, argv, switches);
+    auto processor = std::make_unique<CoherentUpmixAudioProcessor>();
+
+    if (commandLine.has ("help") || commandLine.has ("list-parameters"))
+    {
+        printUsage (*processor);
+        return 0;
+    }
+
+    const bool batchMode = commandLine.has ("output-dir");
+    const int expectedPositional = batchMode ? juce::jmax (1, commandLine.getPositional().size()) : 2;
+
+    if (commandLine.getError().isNotEmpty() || commandLine.getPositional().size() != expectedPositional)
+    {
+        std::cerr << (commandLine.getError().isNotEmpty() ? commandLine.getError() : "Eingang und Ausgang angeben")
+                  << "\n\n";
+        printUsage (*processor);
+        return 1;
+    }
+
+    if (auto result = ParameterFlags::apply (*processor, commandLine, toolOptions); result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    OfflineRender::Settings settings;
+    settings.blockSize     = commandLine.getInt ("block", settings.blockSize);
+    settings.bitsPerSample = commandLine.getInt ("bits", settings.bitsPerSample);
+    settings.outputChannels = commandLine.getInt ("outputs", settings.outputChannels);
+
+    if (! OfflineRender::isSupportedOutputCount (settings.outputChannels))
+    {
+        std::cerr << "--outputs: 2, 6, 8 oder 12, nicht " << settings.outputChannels << std::endl;
+        return 1;
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    if (batchMode)
+        return runBatch (commandLine, formats, settings);
+
+    const auto cwd    = juce::File::getCurrentWorkingDirectory();
+    const auto input  = cwd.getChildFile (commandLine.getPositional()[0]);
+    const auto output = cwd.getChildFile (commandLine.getPositional()[1]);
+
+    if (commandLine.getInt ("segments", 1) > 1)
+        return runSegmented (commandLine, formats, settings, input, output);
+
+    OfflineRender::Stats stats;
+    auto result = OfflineRender::renderFile (*processor, formats, input, output, settings, stats);
+
+    if (result.failed())
+    {
+        std::cerr << input.getFileName() << ": " << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    std::cout << input.getFileName() << " -> " << output.getFileName() << ": "
+              << OfflineRender::describe (stats) << std::endl;
+    return 0;
+}
@@ -0,0 +1,309 @@
+/*
+==============================================================================
+    UpmixStress.cpp
+
+    Worst-Case-Test für processBlock mit zufälligem Host-Verhalten:
+
+        UpmixStress [--calls 200000] [--rate 48000] [--block 512] [--inputs 6] [--outputs 6]
+                    [--seed 1] [--max-load 0.5] [--<parameterID> <wert> ...]
+
+    Pro Aufruf würfelt der simulierte Host:
+      - die Blockgröße (meist nominal, oft kleiner, manchmal bis 4x größer),
+      - Automations-Bursts auf allen APVTS-Parametern,
+      - Moduswechsel,
+      - den Inhalt: Stille / nur L+R / echtes 5.1 (schaltet Idle-Gate und 5.1-Detektor).
+
+    Gemessen wird nur processBlock. Deadline eines Aufrufs ist die Periode
+    des Host-Callbacks: max(n, block) / rate - kurze Teilblöcke (z.B. an
+    Automationspunkten) müssen sich die Periode des vollen Blocks teilen.
+    Exit-Code 1, wenn ein Aufruf mehr als --max-load der Deadline braucht.
+==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "CommandLine.h"
+#include "ParameterFlags.h"
+#include "LatencyHistogram.h"
+#include "OutputLayout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+    const juce::StringArray switches    { "help" };
+    const juce::StringArray toolOptions { "help", "calls", "rate", "block", "inputs", "outputs", "seed", "max-load" };
+
+    enum class Content { silence, stereo, surround };
+
+    /** Was der Host vor einem Aufruf verändert hat - für die Liste der schlimmsten Aufrufe. */
+    struct Events
+    {
+        bool automation = false;
+        bool modeFlip   = false;
+        bool contentChanged = false;
+        Content content = Content::stereo;
+
+        juce::String describe() const
+        {
+            juce::StringArray s;
+            s.add (content == Content::silence ? "Stille" : content == Content::stereo ? "L/R" : "5.1");
+
+            if (automation)      s.add ("Automation");
+            if (modeFlip)        s.add ("Moduswechsel");
+            if (contentChanged)  s.add ("Inhaltswechsel");
+
+            return s.joinIntoString (", ");
+        }
+    };
+
+    struct Call
+    {
+        juce::int64 index = 0;
+        int numSamples = 0;
+        double load = 0.0;
+        int mode = 0;
+        Events events;
+    };
+
+    //==============================================================================
+    class HostSimulator
+    {
+    public:
+        HostSimulator (CoherentUpmixAudioProcessor& p, int nominalBlock, int numInputChannels, juce::int64 seed)
+            : nominal (nominalBlock), numInputs (numInputChannels), random (seed),
+              noise (6, 1 << 17)
+        {
+            for (int ch = 0; ch < noise.getNumChannels(); ++ch)
+                for (int i = 0; i < noise.getNumSamples(); ++i)
+                    noise.setSample (ch, i, 0.5f * (2.0f * random.nextFloat() - 1.0f));
+
+            // Der Modus wird getrennt (und seltener) umgeschaltet als die übrigen Parameter
+            modeParameter = p.getValueTreeState().getParameter ("processingMode");
+
+            for (auto* parameter : p.getParameters())
+                if (parameter != modeParameter)
+                    automatable.push_back (parameter);
+        }
+
+        /** Würfelt Blockgröße, Parameter und Inhalt für den nächsten Aufruf. */
+        int prepareNextCall (juce::AudioBuffer<float>& buffer, Events& events)
+        {
+            events = {};
+
+            // Blockgröße: 60 % nominal, 25 % kleiner, 15 % größer als angekündigt
+            const float r = random.nextFloat();
+            const int numSamples = r < 0.6f  ? nominal
+                                 : r < 0.85f ? 1 + random.nextInt (nominal)
+                                             : nominal + 1 + random.nextInt (3 * nominal);
+
+            // Automations-Burst: einige Aufrufe lang springen ALLE Parameter
+            if (burstRemaining == 0 && random.nextFloat() < 0.01f)
+                burstRemaining = 1 + random.nextInt (32);
+
+            if (burstRemaining > 0)
+            {
+                --burstRemaining;
+                events.automation = true;
+
+                for (auto* parameter : automatable)
+                {
+                    // Mal Sprünge an die Grenzen, mal beliebige Werte
+                    const float value = random.nextFloat() < 0.2f ? (float) random.nextInt (2) : random.nextFloat();
+                    parameter->setValueNotifyingHost (value);
+                }
+            }
+
+            if (modeParameter != nullptr && random.nextFloat() < 0.005f)
+            {
+                const int numModes = juce::jmax (2, modeParameter->getNumSteps());
+                modeParameter->setValueNotifyingHost (modeParameter->convertTo0to1 ((float) random.nextInt (numModes)));
+                events.modeFlip = true;
+            }
+
+            if (random.nextFloat() < 0.005f)
+            {
+                const Content previous = content;
+                const int choice = random.nextInt (numInputs == 6 ? 3 : 2);
+                content = choice == 0 ? Content::silence : choice == 1 ? Content::stereo : Content::surround;
+                events.contentChanged = content != previous;
+            }
+
+            events.content = content;
+            fillInput (buffer, numSamples);
+            return numSamples;
+        }
+
+        int getMode() const
+        {
+            return modeParameter != nullptr ? juce::roundToInt (modeParameter->convertFrom0to1 (modeParameter->getValue())) : 0;
+        }
+
+    private:
+        void fillInput (juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            if (position + numSamples > noise.getNumSamples())
+                position = 0;
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                const bool audible = ch < numInputs
+                                  && (content == Content::surround || (content == Content::stereo && ch < 2));
+
+                if (audible)
+                    buffer.copyFrom (ch, 0, noise, ch, position, numSamples);
+                else
+                    buffer.clear (ch, 0, numSamples);
+            }
+
+            position += numSamples;
+        }
+
+        const int nominal;
+        const int numInputs;
+        juce::Random random;
+        juce::AudioBuffer<float> noise;
+
+        std::vector<juce::AudioProcessorParameter*> automatable;
+        juce::RangedAudioParameter* modeParameter = nullptr;
+
+        Content content = Content::stereo;
+        int burstRemaining = 0;
+        int position = 0;
+    };
+
+    void keepWorst (std::vector<Call>& worst, const Call& call, size_t maxEntries = 8)
+    {
+        if (worst.size() == maxEntries && call.load <= worst.back().load)
+            return;
+
+        auto it = std::upper_bound (worst.begin(), worst.end(), call,
+                                    [] (const Call& a, const Call& b) { return a.load > b.load; });
+        worst.insert (it, call);
+
+        if (worst.size() > maxEntries)
+            worst.pop_back();
+    }
+
+    juce::String micros (juce::uint64 nanoseconds)
+    {
+        return juce::String ((double) nanoseconds / 1000.0, 1) + " us";
+    }
+
+    juce::String percentOfDeadline (juce::uint64 partsPerMillion)
+    {
+        return juce::String ((double) partsPerMillion / 1.0e4, 2) + " %";
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    CommandLine commandLine (argc, argv, switches);
+    CoherentUpmixAudioProcessor processor;
+
+    if (commandLine.has ("help") || commandLine.getError().isNotEmpty())
+    {
+        std::cout << "UpmixStress [--calls <n>] [--rate <hz>] [--block <n>] [--inputs <2|6>] [--outputs <2|6|8|12>]\n"
+                     "            [--seed <n>] [--max-load <anteil>] [--<parameterID> <wert> ...]\n\n"
+                     "  --outputs    Stereo, 5.1, 7.1 oder 7.1.4 (Default 6, bei --inputs 6 nur 6)\n"
+                     "  --max-load   erlaubter Anteil der Deadline pro Aufruf (Default 0.5)\n\n"
+                  << ParameterFlags::describe (processor) << std::endl;
+        return commandLine.getError().isNotEmpty() ? 1 : 0;
+    }
+
+    if (auto result = ParameterFlags::apply (processor, commandLine, toolOptions); result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    const juce::int64 numCalls = commandLine.get ("calls", "200000").getLargeIntValue();
+    const double sampleRate    = commandLine.get ("rate", "48000").getDoubleValue();
+    const int blockSize        = juce::jmax (1, commandLine.getInt ("block", 512));
+    const int numInputs        = commandLine.getInt ("inputs", 6) == 2 ? 2 : 6;
+    const auto outputChannels  = OutputLayout::getChannelSet (commandLine.getInt ("outputs", 6));
+    const int numChannels      = juce::jmax (numInputs, outputChannels.size());
+    const double maxLoad       = commandLine.get ("max-load", "0.5").getDoubleValue();
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add (numInputs == 2 ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::create5point1());
+    layout.outputBuses.add (outputChannels);
+
+    if (! processor.setBusesLayout (layout))
+    {
+        std::cerr << "Layout wird nicht unterstützt: " << numInputs << " -> " << outputChannels.size() << " Kanäle" << std::endl;
+        return 1;
+    }
+
+    processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+    processor.prepareToPlay (sampleRate, blockSize);
+
+    HostSimulator host (processor, blockSize, numInputs, commandLine.get ("seed", "1").getLargeIntValue());
+
+    // Platz für Blöcke bis 4x nominal; der Aufruf sieht nur die ersten n Samples
+    juce::AudioBuffer<float> storage (numChannels, 4 * blockSize);
+    juce::MidiBuffer midi;
+
+    LatencyHistogram durations;   // ns
+    LatencyHistogram loads;       // Anteil der Deadline in ppm
+    std::vector<Call> worst;
+
+    for (juce::int64 index = 0; index < numCalls; ++index)
+    {
+        Call call;
+        call.index      = index;
+        call.numSamples = host.prepareNextCall (storage, call.events);
+        call.mode       = host.getMode();
+
+        juce::AudioBuffer<float> buffer (storage.getArrayOfWritePointers(), numChannels, call.numSamples);
+
+        const auto start = std::chrono::steady_clock::now();
+        processor.processBlock (buffer, midi);
+        const auto elapsed = (juce::uint64) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now() - start).count();
+
+        const double deadlineNs = 1.0e9 * juce::jmax (call.numSamples, blockSize) / sampleRate;
+        call.load = (double) elapsed / deadlineNs;
+
+        durations.record (elapsed);
+        loads.record ((juce::uint64) (call.load * 1.0e6));
+        keepWorst (worst, call);
+    }
+
+    processor.releaseResources();
+
+    const double deadlineMs = 1000.0 * blockSize / sampleRate;
+
+    std::cout << numCalls << " Aufrufe, Block " << blockSize << " @ " << sampleRate << " Hz, "
+              << numInputs << " -> " << outputChannels.size() << " Kanäle, Deadline " << juce::String (deadlineMs, 2) << " ms\n\n"
+              << "               p50          p99          p99.9        max\n"
+              << "Dauer        " << micros (durations.getPercentile (50.0)).paddedRight (' ', 13)
+                                 << micros (durations.getPercentile (99.0)).paddedRight (' ', 13)
+                                 << micros (durations.getPercentile (99.9)).paddedRight (' ', 13)
+                                 << micros (durations.getMax()) << "\n"
+              << "Deadline     " << percentOfDeadline (loads.getPercentile (50.0)).paddedRight (' ', 13)
+                                 << percentOfDeadline (loads.getPercentile (99.0)).paddedRight (' ', 13)
+                                 << percentOfDeadline (loads.getPercentile (99.9)).paddedRight (' ', 13)
+                                 << percentOfDeadline (loads.getMax()) << "\n\n"
+              << "Schlimmste Aufrufe:" << std::endl;
+
+    for (const auto& call : worst)
+        std::cout << "  #" << juce::String (call.index).paddedRight (' ', 9)
+                  << "n=" << juce::String (call.numSamples).paddedRight (' ', 6)
+                  << juce::String (call.load * 100.0, 2).paddedLeft (' ', 7) << " %   Modus " << call.mode
+                  << ", " << call.events.describe() << std::endl;
+
+    const double maxSeen = worst.empty() ? 0.0 : worst.front().load;
+
+    if (maxSeen > maxLoad)
+    {
+        std::cerr << "\nFEHLER: max " << juce::String (maxSeen * 100.0, 2) << " % der Deadline liegt über "
+                  << juce::String (maxLoad * 100.0, 2) << " %" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}